@@ -0,0 +1,45 @@
+#ifndef BOOT_STATE_H
+#define BOOT_STATE_H
+
+#include <Arduino.h>
+#include "clock_state.h"
+
+#define BOOT_STATE_MAGIC 0x54534243  // "CBST" little endian
+
+/**
+ * State kept in RTC memory across software resets (watchdog, panic,
+ * ESP.restart()), lost on power loss
+ */
+typedef struct boot_state
+{
+  uint32_t magic;
+  uint32_t counter;         // last state counter sent to the boards
+  int64_t epoch_ms;         // UTC time of the last save, 0 if unknown
+  int8_t hour;              // last time fully shown, -1 if none
+  int8_t minute;
+  t_half_digitl pose[8];    // last angles sent to each board
+  uint32_t crc;
+} t_boot_state;
+
+/**
+ * Checks the retained state, clears it on power on or if it is corrupted
+ * @return true on a warm boot with a valid state, false otherwise
+ */
+bool begin_boot_state();
+
+/**
+ * Check if the last boot restored a valid state
+ */
+bool is_warm_boot();
+
+/**
+ * Gets the retained state, changes must be followed by save_boot_state()
+ */
+t_boot_state *get_boot_state();
+
+/**
+ * Seals the retained state after a change
+ */
+void save_boot_state();
+
+#endif
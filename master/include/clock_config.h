@@ -3,6 +3,13 @@
 
 #include <Preferences.h>
 
+// Seconds a motor stays energized after its last step (0 = always)
+#define DEFAULT_DRIVER_IDLE_TIMEOUT 10
+#define MAX_DRIVER_IDLE_TIMEOUT 3600
+// Supply current available to the motors (mA, 0 = no limit), see power_model.h
+#define DEFAULT_POWER_BUDGET 0
+#define MAX_POWER_BUDGET 50000
+
 /** 
  * Clock connection's modes
  */
@@ -38,6 +45,7 @@ enum clock_modes
 
 /**
  * Load configuration from the EEPROM
+ * Setters only change the RAM copy, see config_loop()
  */
 void begin_config();
 
@@ -47,10 +55,31 @@ void begin_config();
 void clear_config();
 
 /**
- * Closes the preferencies object
+ * Saves pending changes and closes the preferencies object
  */
 void end_config();
 
+/**
+ * Writes pending changes to the EEPROM as a single record
+ */
+void commit_config();
+
+/**
+ * Commits pending changes once they settled, needs to be called on the main loop
+ */
+void config_loop();
+
+/**
+ * Check if some changes are not saved yet
+ * @return true if the RAM configuration differs from the EEPROM one
+ */
+bool is_config_dirty();
+
+/**
+ * Gets the number of configuration records written so far (flash wear)
+ */
+uint32_t get_config_write_count();
+
 /**
  * Get current clock mode
  */
@@ -63,6 +92,14 @@ int get_clock_mode();
  */
 bool get_sleep_time(int day, int hour);
 
+/**
+ * Gets the time left before the sleep state changes
+ * @param day     day of the week
+ * @param minute  minute of the day (0 <= minute < 1440)
+ * @return minutes until the next sleep/wake transition, -1 if the state never changes
+ */
+int get_next_sleep_transition(int day, int minute);
+
 /**
  * Gets current connection mode
  */
@@ -73,6 +110,24 @@ int get_connection_mode();
  */
 int get_timezone();
 
+/**
+ * Gets current time zone rule
+ * @return POSIX TZ string or zone name, empty if only the UTC offset is used
+ */
+const char *get_timezone_rule();
+
+/**
+ * Gets the time a motor stays energized after its last step
+ * @return seconds, 0 = drivers stay energized
+ */
+uint32_t get_driver_idle_timeout();
+
+/**
+ * Gets the supply current the motors may draw together
+ * @return mA, 0 = no limit
+ */
+uint32_t get_power_budget();
+
 /**
  * Gets current SSID
  */
@@ -97,11 +152,6 @@ void set_clock_mode(int value);
  */
 void set_sleep_time(int day, int hour, bool value);
 
-/**
- *  Saves sleep time array on EEPROM
- */
-void save_sleep_time();
-
 /**
  *  Sets connection mode
  * @param value   mode value of type wireless_modes
@@ -114,6 +164,24 @@ void set_connection_mode(int value);
  */
 void set_timezone(int value);
 
+/**
+ *  Sets the time zone rule, it takes precedence over the UTC offset
+ * @param value   POSIX TZ string or zone name, empty to use the UTC offset
+ */
+void set_timezone_rule(const char *value);
+
+/**
+ *  Sets the time a motor stays energized after its last step
+ * @param value   seconds, 0 = drivers stay energized
+ */
+void set_driver_idle_timeout(uint32_t value);
+
+/**
+ *  Sets the supply current the motors may draw together
+ * @param value   mA, 0 = no limit
+ */
+void set_power_budget(uint32_t value);
+
 /**
  *  Sets SSID value
  * @param value   SSID string
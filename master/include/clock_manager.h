@@ -5,6 +5,14 @@
 #include "i2c.h"
 #include "digit.h"
 #include "clock_config.h"
+#include "pattern_field.h"
+#include "pose.h"
+
+// Motor steps for one revolution, must match STEPS on the slaves
+#define MOTOR_STEPS 5760
+// From the bus time stamp to the slaves receiving the sync beacon:
+// 6 bytes at 100 kHz and the receive interrupt (µs)
+#define BUS_SYNC_LATENCY 600
 
 /** 
  * Returns current direction
@@ -25,11 +33,25 @@ int get_speed();
 int get_acceleration();
 
 /** 
- * Sets current direction
+ * Sets current direction, ROTATE_CLOCKWISE and ROTATE_COUNTERCLOCKWISE
+ * turn the hands at the current speed until the next pose
  * @param value     direction
 */
 void set_direction(int direction);
 
+/** 
+ * Returns how directions are planned
+ * @return style, see direction_styles in direction_planner.h
+*/
+int get_direction_style();
+
+/** 
+ * Sets how directions are planned, the direction gives the way and the
+ * minimum turns
+ * @param value     style, see direction_styles in direction_planner.h
+*/
+void set_direction_style(int value);
+
 /** 
  * Sets current speed
  * @param value     speed
@@ -43,7 +65,9 @@ void set_speed(int value);
 void set_acceleration(int value);
 
 /** 
- * Sends half digit to the specified board
+ * Sends half digit to the specified board, nothing is sent if no hand would move
+ * from the last state sent, unless the previous frame was not acknowledged.
+ * Directions and hand assignment are planned first, see direction_planner.h
  * @param index         board index (0 <= index < 8)
  * @param half_digit    digit to send
 */
@@ -54,27 +78,34 @@ void send_half_digit(int index, t_half_digit half_digit);
  * @param index         board index (0 <= index < 8)
  * @param half_digit    digit to send
 */
-void send_digit(int index, t_digit digit);
+void send_digit(int index, const t_digit &digit);
 
 /** 
  * Sends the full clock configuration to boards
  * @param full_clock    clock configuration
 */
-void send_clock(t_full_clock full_clock);
+void send_clock(const t_full_clock &full_clock);
 
 /** 
  * Converts t_half_digitl to t_half_digit
  * @param lite_digit    t_half_digitl
  * @return t_half_digit
 */
-t_half_digit get_full_half_digit(t_half_digitl lite_digit);
+t_half_digit get_full_half_digit(const t_half_digitl &lite_digit);
 
 /** 
  * Sends the full clock configuration to boards and increments
  * the state counter
  * @param clock_state   clock state
 */
-void set_clock(t_full_clock clock_state);
+void set_clock(const t_full_clock &clock_state);
+
+/** 
+ * Sends a pose to the boards, one frame per column, and increments
+ * the state counter
+ * @param pose    hand angles, see pose.h
+*/
+void set_pose(const t_pose &pose);
 
 /** 
  * Sends a digit to the specified boards and increments
@@ -82,7 +113,7 @@ void set_clock(t_full_clock clock_state);
  * @param index     digit index (0 <= index < 4)
  * @param digit     digit value
 */
-void set_digit(int index, t_digit digit);
+void set_digit(int index, const t_digit &digit);
 
 /** 
  * Sends a half digit to the specified board and increments
@@ -90,7 +121,54 @@ void set_digit(int index, t_digit digit);
  * @param index     digit index (0 <= index < 8)
  * @param half      hlaf digit value
 */
-void set_half_digit(int index, t_half_digitl half);
+void set_half_digit(int index, const t_half_digitl &half);
+
+/** 
+ * Evaluates a field on the 24 clocks and sends the angles straight to the
+ * boards, then increments the state counter
+ * @param field   pattern function
+ * @param t       ms since the pattern started
+*/
+void set_field(t_field field, uint32_t t);
+
+/** 
+ * Plans the directions of a pose sent in parts, all its hands together,
+ * so STYLE_ONE_WAY turns them the same way whichever part they are in
+ * @param target    pose to reach
+ * @param frames    result, one frame per board for set_half_digit_clocks()
+*/
+void plan_pose_frames(const t_full_clock &target, t_half_digit frames[8]);
+
+/** 
+ * Sends some clocks of a planned frame, the others keep their last target,
+ * and increments the state counter
+ * @param index     digit index (0 <= index < 8)
+ * @param planned   frame of the board from plan_pose_frames()
+ * @param clocks    bitmask of the clocks to send (bit = row)
+*/
+void set_half_digit_clocks(int index, const t_half_digit &planned, uint8_t clocks);
+
+/** 
+ * Same as set_half_digit_clocks(), the board holds the frame until the bus
+ * time reaches start_us, see send_sync_beacon()
+ * @param index       digit index (0 <= index < 8)
+ * @param planned     frame of the board from plan_pose_frames()
+ * @param clocks      bitmask of the clocks to send (bit = row)
+ * @param start_us    bus time to start at (µs)
+*/
+void set_half_digit_clocks_at(int index, const t_half_digit &planned, uint8_t clocks, uint32_t start_us);
+
+/**
+ * Returns the bus time, the time base of timed frames
+ * @return µs, wraps every 71 minutes
+*/
+uint32_t get_bus_time();
+
+/**
+ * Sends the bus time to all boards at once (I2C general call),
+ * boards without it start timed frames on arrival
+*/
+void send_sync_beacon();
 
 /** 
  * Sets the specified time on the clock
@@ -99,6 +177,13 @@ void set_half_digit(int index, t_half_digitl half);
 */
 void set_clock_time(int h, int m);
 
+/** 
+ * Returns the pattern of a digit
+ * @param value     digit (0 <= value < 10)
+ * @return digit pattern, in flash
+*/
+const t_digit &get_digit(int value);
+
 /** 
  * Returns a full clock state from time
  * @param h     hour
@@ -114,10 +199,115 @@ t_full_clock get_clock_state_from_time(int h, int m);
 */
 void adjust_hands(int clock_index, int h_amount, int m_amount);
 
+/**
+ * Returns the angle a hand travels to reach a target, mirrors
+ * ClockAccelStepper::moveToAngle() on the slaves
+ * @param from      current angle
+ * @param to        target angle
+ * @param mode      direction mode
+ * @return travel in degrees, extra revolutions included
+*/
+int get_hand_travel(int from, int to, int mode);
+
+/**
+ * Estimates the duration of a move with a trapezoidal speed profile
+ * @param degrees   travel in degrees
+ * @param speed     max speed (steps/sec)
+ * @param accel     acceleration (steps/sec^2)
+ * @return duration in milliseconds
+*/
+uint32_t estimate_move_ms(int degrees, int speed, int accel);
+
+/**
+ * Returns the estimated duration of the last sent transition,
+ * i.e. the slowest hand of the last set_clock/set_digit/set_half_digit call
+ * @return duration in milliseconds
+*/
+uint32_t get_last_transition_ms();
+
+/**
+ * Clears the highest modeled motor load, see power_model.h
+*/
+void reset_peak_load();
+
+/**
+ * Returns the highest modeled motor load since reset_peak_load()
+ * @return mA
+*/
+uint32_t get_peak_load();
+
+/**
+ * Keeps the highest modeled motor load as the one of a clock mode
+ * @param mode    clock mode, OFF is ignored
+*/
+void save_peak_load(int mode);
+
+/**
+ * Returns the highest modeled motor load of the last animation of a clock mode
+ * @param mode    clock mode
+ * @return mA, 0 if the mode didn't run yet
+*/
+uint32_t get_mode_peak_load(int mode);
+
+/**
+ * Returns the last state sent to a board
+ * @param index     board index (0 <= index < 8)
+ * @return half digit
+*/
+t_half_digit get_last_half_digit(int index);
+
+/**
+ * Returns the angles last sent to the boards
+ * @return pose
+*/
+t_pose get_last_pose();
+
+/**
+ * Gets the number of half digit frames sent and skipped since boot
+ * @param sent      frames written to the bus
+ * @param skipped   frames skipped because no hand would move
+*/
+void get_send_stats(uint32_t &sent, uint32_t &skipped);
+
+/**
+ * Reads the status of a board
+ * @param index     board index (0 <= index < 8)
+ * @param status    board status
+ * @return true if the board answered, false otherwise
+*/
+bool read_board_status(int index, t_board_status &status);
+
+/**
+ * Initializes the known hands position from the retained state
+ * (see boot_state.h) and from what the boards report
+ * @return number of boards that answered
+*/
+int sync_clock_state();
+
 /**
  * Send enable/disable command to all slave boards
  * @param enabled   true = enable drivers, false = disable drivers (deferred)
 */
 void set_all_drivers_enabled(bool enabled);
 
+/**
+ * Send enable/disable command to a single board, enabling also wakes
+ * the motors de-energized after an idle timeout
+ * @param index     board index (0 <= index < 8)
+ * @param enabled   true = enable drivers, false = disable drivers (deferred)
+*/
+void set_board_drivers_enabled(int index, bool enabled);
+
+/**
+ * Sets how long the boards keep a motor energized after its last step
+ * @param seconds   idle timeout, 0 = never de-energize
+*/
+void set_all_idle_timeout(uint16_t seconds);
+
+/**
+ * Starts a homing of all hands against the dial stop, on all boards at once.
+ * Boards answer with STATUS_HOMING until done, then go back to their last target
+*/
+void home_all_boards();
+
 #endif
\ No newline at end of file
@@ -18,7 +18,9 @@ enum directions
   MAX_DISTANCE,
   MAX_DISTANCE2,
   MAX_DISTANCE3,
-  ADJUST_HAND
+  ADJUST_HAND,
+  ROTATE_CLOCKWISE,         // turns until the next frame: speed = steps/sec, angle = angle at bus time 0
+  ROTATE_COUNTERCLOCKWISE
 };
 
 typedef struct clock_state
@@ -41,6 +43,45 @@ typedef struct half_digit
   uint32_t change_counter[3];
 } t_half_digit;
 
+// Frame held by the board until the bus time reaches start_us, see CMD_SYNC
+typedef struct timed_half_digit
+{
+  t_half_digit half_digit;
+  uint32_t start_us;              // bus time (µs), a frame already late starts at once
+} t_timed_half_digit;
+
+// Answer to Wire.requestFrom(), layout changes bump BOARD_STATUS_VERSION
+#define BOARD_STATUS_VERSION 6
+
+enum board_status_flags
+{
+  STATUS_RUNNING = 0x01,          // at least one hand is moving
+  STATUS_DRIVERS_ENABLED = 0x02,
+  STATUS_POSITION_UNCERTAIN = 0x04, // a power loss interrupted a move, see uncertain
+  STATUS_HOMING = 0x08,
+  STATUS_DRIVERS_STANDBY = 0x10,  // disabled with a low hold current, hands held
+  STATUS_SYNCED = 0x20            // bus time received, timed frames start on time
+};
+
+typedef struct board_status
+{
+  uint8_t version;
+  uint8_t flags;
+  uint8_t uncertain;              // bitmask of the hands with an unknown position
+  uint8_t homed;                  // bitmask of the hands that found the stop during the last homing
+  uint16_t angle[6];              // believed hand angles: h0, m0, h1, m1, h2, m2
+  uint32_t change_counter[3];     // last applied counter per clock
+  int16_t home_offset[6];         // error corrected by the last homing (degrees)
+  uint8_t driver_flags[6];        // TMC2209 telemetry per motor, see slave tmc2209.h
+  uint8_t driver_temperature[6];  // highest threshold passed (°C)
+  uint8_t driver_load[6];         // SG_RESULT / 2, lower = more load, 0xFF at standstill
+  uint8_t driver_current[6];      // CS_ACTUAL, 0..31
+  uint32_t power_seconds[4];      // motor-seconds running, holding, standby, off since boot
+  uint8_t gated;                  // bitmask of the motors de-energized after an idle timeout
+  uint8_t queued;                 // timed frames waiting for their start
+  uint8_t reserved[2];
+} t_board_status;
+
 /***************** Local *****************/
 typedef struct clock_state_lite
 {
@@ -5,137 +5,226 @@
 #include "clock_state.h"
 
 /**
- * Digits
+ * Patterns are built at compile time and end up in flash (.rodata).
+ * A digit is 2 columns of 3 clocks, halfs[0] is the left column,
+ * clocks[0] the top one.
  * structure: {
- * h0, m0,
- * h1, m1,
- * ...
- * h5, m5
+ * h0, m0,   h3, m3,
+ * h1, m1,   h4, m4,
+ * h2, m2,   h5, m5
  * }
 */
 
-const t_digit digit_0 = {
-  270, 0,
-  270, 90,
-  0, 90,
-  270, 180,
-  270, 90,
-  180, 90
-};
-
-const t_digit digit_1 = {
-  225, 225,
-  225, 225,
-  225, 225,
-  270, 270,
-  270, 90,
-  90, 90
-};
-
-const t_digit digit_2 = {
-  0, 0,
-  270, 0,
-  90, 0,
-  180, 270,
-  90, 180,
-  180, 180
-};
-
-const t_digit digit_3 = {
-  0, 0,
-  0, 0,
-  0, 0,
-  180, 270,
-  180, 90,
-  180, 90
-};
-
-const t_digit digit_4 = {
-  270, 270,
-  90, 0,
-  225, 225,
-  270, 270,
-  270, 90,
-  90, 90
-};
-
-const t_digit digit_5 = {
-  270, 0,
-  90, 0,
-  0, 0,
-  180, 180,
-  270, 180,
-  90, 180
-};
-
-const t_digit digit_6 = {
-  270, 0,
-  270, 90,
-  90, 0,
-  180, 180,
-  270, 180,
-  90, 180
-};
-
-const t_digit digit_7 = {
-  0, 0,
-  225, 225,
-  225, 225,
-  270, 180,
-  270, 90,
-  90, 90
-};
-
-const t_digit digit_8 = {
-  270, 0,
-  90, 0,
-  90, 0,
-  270, 180,
-  90, 180,
-  90, 180
-};
-
-const t_digit digit_9 = {
-  270, 0,
-  0, 90,
-  0, 0,
-  270, 180,
-  270, 90,
-  90, 180
-};
-
-const t_digit digit_null = {
-  270, 270,
-  270, 270,
-  270, 270,
-  270, 270,
-  270, 270,
-  270, 270
-};
-
-const t_digit digit_I = {
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90
-};
-
-const t_digit digit_fun = {
-  225, 45,
-  225, 45,
-  225, 45,
-  225, 45,
-  225, 45,
-  225, 45,
-};
-
-const t_full_clock d_stop = {digit_null, digit_null, digit_null, digit_null};
-
-const t_full_clock d_fun = {digit_fun, digit_fun, digit_fun, digit_fun};
-
-const t_full_clock d_IIII = {digit_I, digit_I, digit_I, digit_I};
+/**
+ * @param h     hour hand angle
+ * @param m     minute hand angle
+*/
+constexpr t_clockl cell(uint16_t h, uint16_t m)
+{
+  return t_clockl{h, m};
+}
+
+/**
+ * Column of 3 clocks, top to bottom
+*/
+constexpr t_half_digitl make_column(t_clockl top, t_clockl middle, t_clockl bottom)
+{
+  return t_half_digitl{{top, middle, bottom}};
+}
+
+/**
+ * Digit from its 6 cells, left column top to bottom then right column
+*/
+constexpr t_digit make_digit(t_clockl l0, t_clockl l1, t_clockl l2, t_clockl r0, t_clockl r1, t_clockl r2)
+{
+  return t_digit{{make_column(l0, l1, l2), make_column(r0, r1, r2)}};
+}
+
+/**
+ * Digit from its 2 columns
+*/
+constexpr t_digit make_digit(t_half_digitl left, t_half_digitl right)
+{
+  return t_digit{{left, right}};
+}
+
+/**
+ * Digit with both columns equal
+*/
+constexpr t_digit column_digit(t_clockl top, t_clockl middle, t_clockl bottom)
+{
+  return make_digit(make_column(top, middle, bottom), make_column(top, middle, bottom));
+}
+
+/**
+ * Digit with the same cell everywhere
+*/
+constexpr t_digit fill_digit(t_clockl c)
+{
+  return column_digit(c, c, c);
+}
+
+constexpr t_full_clock make_clock(t_digit d0, t_digit d1, t_digit d2, t_digit d3)
+{
+  return t_full_clock{{d0, d1, d2, d3}};
+}
+
+constexpr t_full_clock fill_clock(t_digit d)
+{
+  return make_clock(d, d, d, d);
+}
+
+// Mirror used by the symmetric patterns, angle -> 360 - angle
+constexpr uint16_t mirror_angle(uint16_t angle)
+{
+  return (360 - angle) % 360;
+}
+
+constexpr t_clockl mirror_cell(t_clockl c)
+{
+  return cell(mirror_angle(c.angle_h), mirror_angle(c.angle_m));
+}
+
+constexpr t_half_digitl mirror_column(t_half_digitl c)
+{
+  return make_column(mirror_cell(c.clocks[0]), mirror_cell(c.clocks[1]), mirror_cell(c.clocks[2]));
+}
+
+constexpr t_digit mirror_digit(t_digit d)
+{
+  return make_digit(mirror_column(d.halfs[1]), mirror_column(d.halfs[0]));
+}
+
+// Adds the same angle to every hand
+constexpr t_clockl rotate_cell(t_clockl c, uint16_t degrees)
+{
+  return cell((c.angle_h + degrees) % 360, (c.angle_m + degrees) % 360);
+}
+
+constexpr t_half_digitl rotate_column(t_half_digitl c, uint16_t degrees)
+{
+  return make_column(rotate_cell(c.clocks[0], degrees), rotate_cell(c.clocks[1], degrees),
+                     rotate_cell(c.clocks[2], degrees));
+}
+
+constexpr t_digit rotate_digit(t_digit d, uint16_t degrees)
+{
+  return make_digit(rotate_column(d.halfs[0], degrees), rotate_column(d.halfs[1], degrees));
+}
+
+/**
+ * Gets the column shown by a board
+ * @param clock     full clock
+ * @param index     board index (0 <= index < 8)
+*/
+constexpr const t_half_digitl &get_column(const t_full_clock &clock, int index)
+{
+  return clock.digit[index / 2].halfs[index % 2];
+}
+
+// Compile time checks
+constexpr bool valid_cell(const t_clockl &c)
+{
+  return c.angle_h < 360 && c.angle_m < 360 && c.angle_h % 15 == 0 && c.angle_m % 15 == 0;
+}
+
+constexpr bool valid_column(const t_half_digitl &c)
+{
+  return valid_cell(c.clocks[0]) && valid_cell(c.clocks[1]) && valid_cell(c.clocks[2]);
+}
+
+constexpr bool valid_digit(const t_digit &d)
+{
+  return valid_column(d.halfs[0]) && valid_column(d.halfs[1]);
+}
+
+constexpr bool valid_clock(const t_full_clock &c)
+{
+  return valid_digit(c.digit[0]) && valid_digit(c.digit[1]) && valid_digit(c.digit[2]) && valid_digit(c.digit[3]);
+}
+
+// Same picture, hands may be swapped
+constexpr bool same_cell(const t_clockl &a, const t_clockl &b)
+{
+  return (a.angle_h == b.angle_h && a.angle_m == b.angle_m) || (a.angle_h == b.angle_m && a.angle_m == b.angle_h);
+}
+
+constexpr bool mirrored_column(const t_half_digitl &a, const t_half_digitl &b)
+{
+  return same_cell(mirror_cell(a.clocks[0]), b.clocks[0]) && same_cell(mirror_cell(a.clocks[1]), b.clocks[1]) &&
+         same_cell(mirror_cell(a.clocks[2]), b.clocks[2]);
+}
+
+constexpr bool mirrored_digit(const t_digit &a, const t_digit &b)
+{
+  return mirrored_column(a.halfs[0], b.halfs[1]) && mirrored_column(a.halfs[1], b.halfs[0]);
+}
+
+// Right half is the mirror of the left half
+constexpr bool symmetric_clock(const t_full_clock &c)
+{
+  return mirrored_digit(c.digit[0], c.digit[3]) && mirrored_digit(c.digit[1], c.digit[2]);
+}
+
+// ============================================
+// DIGITS
+// ============================================
+
+// Blank cell of the digits, both hands on the diagonal
+constexpr t_clockl c_blank = cell(225, 225);
+
+constexpr t_digit digit_0 = make_digit(
+  cell(270, 0), cell(270, 90), cell(0, 90),
+  cell(270, 180), cell(270, 90), cell(180, 90));
+
+constexpr t_digit digit_1 = make_digit(
+  c_blank, c_blank, c_blank,
+  cell(270, 270), cell(270, 90), cell(90, 90));
+
+constexpr t_digit digit_2 = make_digit(
+  cell(0, 0), cell(270, 0), cell(90, 0),
+  cell(180, 270), cell(90, 180), cell(180, 180));
+
+constexpr t_digit digit_3 = make_digit(
+  cell(0, 0), cell(0, 0), cell(0, 0),
+  cell(180, 270), cell(180, 90), cell(180, 90));
+
+constexpr t_digit digit_4 = make_digit(
+  cell(270, 270), cell(90, 0), c_blank,
+  cell(270, 270), cell(270, 90), cell(90, 90));
+
+constexpr t_digit digit_5 = make_digit(
+  cell(270, 0), cell(90, 0), cell(0, 0),
+  cell(180, 180), cell(270, 180), cell(90, 180));
+
+constexpr t_digit digit_6 = make_digit(
+  cell(270, 0), cell(270, 90), cell(90, 0),
+  cell(180, 180), cell(270, 180), cell(90, 180));
+
+constexpr t_digit digit_7 = make_digit(
+  cell(0, 0), c_blank, c_blank,
+  cell(270, 180), cell(270, 90), cell(90, 90));
+
+constexpr t_digit digit_8 = make_digit(
+  cell(270, 0), cell(90, 0), cell(90, 0),
+  cell(270, 180), cell(90, 180), cell(90, 180));
+
+constexpr t_digit digit_9 = make_digit(
+  cell(270, 0), cell(0, 90), cell(0, 0),
+  cell(270, 180), cell(270, 90), cell(90, 180));
+
+// Both hands down, rest position
+constexpr t_digit digit_null = fill_digit(cell(270, 270));
+
+constexpr t_digit digit_I = fill_digit(cell(270, 90));
+
+constexpr t_digit digit_fun = fill_digit(cell(225, 45));
+
+constexpr t_full_clock d_stop = fill_clock(digit_null);
+
+constexpr t_full_clock d_fun = fill_clock(digit_fun);
+
+constexpr t_full_clock d_IIII = fill_clock(digit_I);
 
 // ============================================
 // NEW CHOREOGRAPHY SHAPES
@@ -143,240 +232,110 @@ const t_full_clock d_IIII = {digit_I, digit_I, digit_I, digit_I};
 // ============================================
 
 // SPINNING: Vertical lines pointing up/down (visible |)
-const t_digit digit_spin_up = {
-  0, 180,    // vertical line |
-  0, 180,
-  0, 180,
-  0, 180,
-  0, 180,
-  0, 180
-};
-
-// SPINNING: Vertical lines pointing down/up (visible |)
-const t_digit digit_spin_down = {
-  180, 0,    // vertical line | (inverted rotation)
-  180, 0,
-  180, 0,
-  180, 0,
-  180, 0,
-  180, 0
-};
+constexpr t_digit digit_spin_up = fill_digit(cell(0, 180));
+
+// SPINNING: Vertical lines pointing down/up (visible |, inverted rotation)
+constexpr t_digit digit_spin_down = rotate_digit(digit_spin_up, 180);
 
 // SPINNING: Horizontal lines (visible -)
-const t_digit digit_spin_right = {
-  270, 90,   // horizontal line -
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90
-};
-
-const t_full_clock d_spin_up = {digit_spin_up, digit_spin_up, digit_spin_up, digit_spin_up};
-const t_full_clock d_spin_down = {digit_spin_down, digit_spin_down, digit_spin_down, digit_spin_down};
-const t_full_clock d_spin_right = {digit_spin_right, digit_spin_right, digit_spin_right, digit_spin_right};
+constexpr t_digit digit_spin_right = fill_digit(cell(270, 90));
+
+constexpr t_full_clock d_spin_up = fill_clock(digit_spin_up);
+constexpr t_full_clock d_spin_down = fill_clock(digit_spin_down);
+constexpr t_full_clock d_spin_right = fill_clock(digit_spin_right);
 
 // SQUARES: Diamond/square pattern with L-shapes
 // Each clock forms an L-shape or corner
-const t_digit digit_squares_a = {
-  0, 90,      // top: L shape ┐
-  270, 180,   // middle: L shape └
-  0, 90,      // bottom: L shape ┐
-  180, 270,   // top: L shape ┘
-  90, 0,      // middle: L shape ┌
-  180, 270    // bottom: L shape ┘
-};
-
-const t_digit digit_squares_b = {
-  180, 270,   // top: L shape ┘
-  90, 0,      // middle: L shape ┌
-  180, 270,   // bottom: L shape ┘
-  0, 90,      // top: L shape ┐
-  270, 180,   // middle: L shape └
-  0, 90       // bottom: L shape ┐
-};
-
-const t_full_clock d_squares = {digit_squares_a, digit_squares_b, digit_squares_a, digit_squares_b};
+constexpr t_digit digit_squares_a = make_digit(
+  cell(0, 90),            // top: L shape ┐
+  cell(270, 180),         // middle: L shape └
+  cell(0, 90),            // bottom: L shape ┐
+  cell(180, 270),         // top: L shape ┘
+  cell(90, 0),            // middle: L shape ┌
+  cell(180, 270));        // bottom: L shape ┘
+
+// Same corners, columns swapped
+constexpr t_digit digit_squares_b = make_digit(digit_squares_a.halfs[1], digit_squares_a.halfs[0]);
+
+constexpr t_full_clock d_squares = make_clock(digit_squares_a, digit_squares_b, digit_squares_a, digit_squares_b);
 
 // SYMMETRICAL: Left side - arrows pointing left (< shape)
-const t_digit digit_sym_left = {
-  315, 225,   // top: V pointing left <
-  270, 270,   // middle: both left (will overlap but that's OK for center line)
-  225, 315,   // bottom: V pointing left <
-  315, 225,
-  270, 270,
-  225, 315
-};
+constexpr t_digit digit_sym_left = column_digit(
+  cell(315, 225),         // top: V pointing left <
+  cell(270, 270),         // middle: both left (will overlap but that's OK for center line)
+  cell(225, 315));        // bottom: V pointing left <
 
 // SYMMETRICAL: Right side - arrows pointing right (> shape)
-const t_digit digit_sym_right = {
-  45, 135,    // top: V pointing right >
-  90, 90,     // middle: both right
-  135, 45,    // bottom: V pointing right >
-  45, 135,
-  90, 90,
-  135, 45
-};
+constexpr t_digit digit_sym_right = mirror_digit(digit_sym_left);
 
 // SYMMETRICAL: Converge to center - left digits point right (> shape)
-const t_digit digit_sym_converge_right = {
-  45, 135,
-  90, 90,
-  135, 45,
-  45, 135,
-  90, 90,
-  135, 45
-};
+constexpr t_digit digit_sym_converge_right = digit_sym_right;
 
 // SYMMETRICAL: Converge to center - right digits point left (< shape)
-const t_digit digit_sym_converge_left = {
-  315, 225,
-  270, 270,
-  225, 315,
-  315, 225,
-  270, 270,
-  225, 315
-};
-
-// WIND: Wave pattern with diagonal lines
-// h and m at opposite angles create visible diagonal lines
-const t_digit digit_wind_1 = {
-  315, 135,   // top: diagonal \
-  270, 90,    // mid: horizontal -
-  225, 45,    // bot: diagonal /
-  315, 135,
-  270, 90,
-  225, 45
-};
-
-const t_digit digit_wind_2 = {
-  225, 45,    // top: diagonal /
-  270, 90,    // mid: horizontal -
-  315, 135,   // bot: diagonal \
-  225, 45,
-  270, 90,
-  315, 135
-};
-
-const t_digit digit_wind_3 = {
-  270, 90,    // all horizontal
-  315, 135,
-  270, 90,
-  270, 90,
-  225, 45,
-  270, 90
-};
-
-const t_digit digit_wind_4 = {
-  270, 90,
-  225, 45,
-  270, 90,
-  270, 90,
-  315, 135,
-  270, 90
-};
-
-const t_full_clock d_wind_1 = {digit_wind_1, digit_wind_2, digit_wind_3, digit_wind_4};
-const t_full_clock d_wind_2 = {digit_wind_2, digit_wind_3, digit_wind_4, digit_wind_1};
-const t_full_clock d_wind_3 = {digit_wind_3, digit_wind_4, digit_wind_1, digit_wind_2};
+constexpr t_digit digit_sym_converge_left = digit_sym_left;
+
+constexpr t_full_clock d_sym_diverge = make_clock(digit_sym_left, digit_sym_left, digit_sym_right, digit_sym_right);
+constexpr t_full_clock d_sym_converge = make_clock(digit_sym_right, digit_sym_right, digit_sym_left, digit_sym_left);
+
+// Lines, h and m at opposite angles
+constexpr t_clockl c_diag_back = cell(315, 135);   // diagonal, top-left to bottom-right
+constexpr t_clockl c_diag = cell(225, 45);        // diagonal, bottom-left to top-right
+constexpr t_clockl c_vertical = cell(270, 90);    // down and up, the middle bar of digit_0
 
 // FIREWORK: Center explosion pattern
 // Hands point outward from center of display
 
 // Left outer columns (0,1) - arrows pointing left/outward
-const t_digit digit_firework_outer_left = {
-  315, 225,   // top: V pointing left <
-  270, 270,   // middle: both left (center line)
-  225, 315,   // bottom: V pointing left <
-  315, 225,
-  270, 270,
-  225, 315
-};
+constexpr t_digit digit_firework_outer_left = digit_sym_left;
 
 // Left inner columns (2,3) - mixed arrows (transition)
-const t_digit digit_firework_inner_left = {
-  315, 45,    // top: diagonal spread
-  270, 90,    // middle: horizontal line
-  225, 135,   // bottom: diagonal spread
-  0, 180,     // top: vertical line
-  270, 90,    // middle: horizontal line
-  180, 0      // bottom: vertical line
-};
+constexpr t_digit digit_firework_inner_left = make_digit(
+  cell(315, 45),          // top: diagonal spread
+  c_vertical,             // middle: vertical line
+  cell(225, 135),         // bottom: diagonal spread
+  cell(0, 180),           // top: horizontal line
+  c_vertical,             // middle: vertical line
+  cell(180, 0));          // bottom: horizontal line
 
 // Right inner columns (4,5) - mixed arrows (transition)
-const t_digit digit_firework_inner_right = {
-  0, 180,     // top: vertical line
-  270, 90,    // middle: horizontal line
-  180, 0,     // bottom: vertical line
-  45, 315,    // top: diagonal spread
-  270, 90,    // middle: horizontal line
-  135, 225    // bottom: diagonal spread
-};
+constexpr t_digit digit_firework_inner_right = make_digit(
+  cell(0, 180),           // top: horizontal line
+  c_vertical,             // middle: vertical line
+  cell(180, 0),           // bottom: horizontal line
+  cell(45, 315),          // top: diagonal spread
+  c_vertical,             // middle: vertical line
+  cell(135, 225));        // bottom: diagonal spread
 
 // Right outer columns (6,7) - arrows pointing right/outward
-const t_digit digit_firework_outer_right = {
-  45, 135,    // top: V pointing right >
-  90, 90,     // middle: both right (center line)
-  135, 45,    // bottom: V pointing right >
-  45, 135,
-  90, 90,
-  135, 45
-};
+constexpr t_digit digit_firework_outer_right = digit_sym_right;
 
-const t_full_clock d_firework = {digit_firework_outer_left, digit_firework_inner_left, digit_firework_inner_right, digit_firework_outer_right};
+constexpr t_full_clock d_firework = make_clock(digit_firework_outer_left, digit_firework_inner_left,
+                                               digit_firework_inner_right, digit_firework_outer_right);
 
 // CASCADE: Uses d_stop initially, then row-by-row animation
 // (Implemented in code, not as static shapes)
 
 // ============================================
-// OBLIQUES: Diagonal lines pattern
-// All hands form parallel diagonal lines across display
+// OBLIQUES: Diagonal lines pattern, used by DANCE
+// (the OBLIQUES mode computes its frames, see obliques_field)
 // ============================================
 
-// Obliques: diagonal line \ (top-left to bottom-right)
-const t_digit digit_obliques_br = {
-  315, 135,   // h points up-left, m points down-right = diagonal \
-  315, 135,
-  315, 135,
-  315, 135,
-  315, 135,
-  315, 135
-};
-
-// Obliques: diagonal line / (top-right to bottom-left)
-const t_digit digit_obliques_bl = {
-  225, 45,    // h points down-left, m points up-right = diagonal /
-  225, 45,
-  225, 45,
-  225, 45,
-  225, 45,
-  225, 45
-};
-
-// Obliques: diagonal line / (same as bl, alternative name)
-const t_digit digit_obliques_tr = {
-  45, 225,    // h points up-right, m points down-left = diagonal /
-  45, 225,
-  45, 225,
-  45, 225,
-  45, 225,
-  45, 225
-};
-
-// Obliques: diagonal line \ (same as br, alternative name)
-const t_digit digit_obliques_tl = {
-  135, 315,   // h points down-right, m points up-left = diagonal \
-  135, 315,
-  135, 315,
-  135, 315,
-  135, 315,
-  135, 315
-};
-
-const t_full_clock d_obliques_br = {digit_obliques_br, digit_obliques_br, digit_obliques_br, digit_obliques_br};
-const t_full_clock d_obliques_bl = {digit_obliques_bl, digit_obliques_bl, digit_obliques_bl, digit_obliques_bl};
-const t_full_clock d_obliques_tr = {digit_obliques_tr, digit_obliques_tr, digit_obliques_tr, digit_obliques_tr};
-const t_full_clock d_obliques_tl = {digit_obliques_tl, digit_obliques_tl, digit_obliques_tl, digit_obliques_tl};
+// Obliques: h points up-left, m points down-right (diagonal, top-left to bottom-right)
+constexpr t_digit digit_obliques_br = fill_digit(c_diag_back);
+
+// Obliques: h points down-left, m points up-right (diagonal, bottom-left to top-right)
+constexpr t_digit digit_obliques_bl = fill_digit(c_diag);
+
+// Obliques: same line as bl, hands swapped
+constexpr t_digit digit_obliques_tr = rotate_digit(digit_obliques_bl, 180);
+
+// Obliques: same line as br, hands swapped
+constexpr t_digit digit_obliques_tl = rotate_digit(digit_obliques_br, 180);
+
+constexpr t_full_clock d_obliques_br = fill_clock(digit_obliques_br);
+constexpr t_full_clock d_obliques_bl = fill_clock(digit_obliques_bl);
+constexpr t_full_clock d_obliques_tr = fill_clock(digit_obliques_tr);
+constexpr t_full_clock d_obliques_tl = fill_clock(digit_obliques_tl);
 
 // ============================================
 // RIPPLE: Concentric rings from center
@@ -384,56 +343,35 @@ const t_full_clock d_obliques_tl = {digit_obliques_tl, digit_obliques_tl, digit_
 // ============================================
 
 // Center ring (columns 3,4) - tight angles pointing out
-const t_digit digit_ripple_center = {
-  315, 45,    // top: ↖ ↗
-  270, 90,    // middle: ← →
-  225, 135,   // bottom: ↙ ↘
-  315, 45,
-  270, 90,
-  225, 135
-};
+constexpr t_digit digit_ripple_center = make_digit(
+  make_column(cell(315, 45), c_vertical, cell(225, 135)),
+  make_column(cell(315, 45), c_vertical, cell(225, 135)));
 
 // Middle ring (columns 2,5) - slightly more spread
-const t_digit digit_ripple_mid = {
-  300, 60,    // top
-  270, 90,    // middle
-  240, 120,   // bottom
-  300, 60,
-  270, 90,
-  240, 120
-};
+constexpr t_digit digit_ripple_mid = column_digit(cell(300, 60), c_vertical, cell(240, 120));
 
 // Outer ring (columns 0,1,6,7) - most spread out
-const t_digit digit_ripple_outer = {
-  315, 45,    // top
-  270, 90,    // middle
-  225, 135,   // bottom
-  315, 45,
-  270, 90,
-  225, 135
-};
+constexpr t_digit digit_ripple_outer = digit_ripple_center;
 
 // Ripple collapsed (arrows pointing to center)
-const t_digit digit_ripple_in_left = {
-  45, 135,    // top: V pointing right >
-  270, 90,    // middle: horizontal line -
-  135, 45,    // bottom: V pointing right >
-  45, 135,
-  270, 90,
-  135, 45
-};
-
-const t_digit digit_ripple_in_right = {
-  315, 225,   // top: V pointing left <
-  270, 90,    // middle: horizontal line -
-  225, 315,   // bottom: V pointing left <
-  315, 225,
-  270, 90,
-  225, 315
-};
-
-const t_full_clock d_ripple_out = {digit_ripple_outer, digit_ripple_mid, digit_ripple_center, digit_ripple_outer};
-const t_full_clock d_ripple_in = {digit_ripple_in_left, digit_ripple_in_left, digit_ripple_in_right, digit_ripple_in_right};
+constexpr t_digit digit_ripple_in_left = column_digit(
+  cell(45, 135),          // top: V pointing right >
+  c_vertical,             // middle: vertical line |
+  cell(135, 45));         // bottom: V pointing right >
+
+constexpr t_digit digit_ripple_in_right = column_digit(
+  cell(315, 225),         // top: V pointing left <
+  c_vertical,             // middle: vertical line |
+  cell(225, 315));        // bottom: V pointing left <
+
+// Columns 2 and 5 are the middle ring, 3 and 4 the center one
+constexpr t_full_clock d_ripple_out = make_clock(
+  digit_ripple_outer,
+  make_digit(digit_ripple_mid.halfs[0], digit_ripple_center.halfs[1]),
+  make_digit(digit_ripple_center.halfs[0], digit_ripple_mid.halfs[1]),
+  digit_ripple_outer);
+constexpr t_full_clock d_ripple_in = make_clock(digit_ripple_in_left, digit_ripple_in_left,
+                                                digit_ripple_in_right, digit_ripple_in_right);
 
 // ============================================
 // BREATHE: Expansion/contraction from center
@@ -441,106 +379,21 @@ const t_full_clock d_ripple_in = {digit_ripple_in_left, digit_ripple_in_left, di
 // ============================================
 
 // Breathe expanded - hands spread outward (V shapes pointing out)
-const t_digit digit_breathe_expand_left = {
-  315, 225,   // top: V pointing left <
-  270, 270,   // middle: both left (center line)
-  225, 315,   // bottom: V pointing left <
-  315, 225,
-  270, 270,
-  225, 315
-};
-
-const t_digit digit_breathe_expand_right = {
-  45, 135,    // top: V pointing right >
-  90, 90,     // middle: both right (center line)
-  135, 45,    // bottom: V pointing right >
-  45, 135,
-  90, 90,
-  135, 45
-};
+constexpr t_digit digit_breathe_expand_left = digit_sym_left;
+constexpr t_digit digit_breathe_expand_right = digit_sym_right;
 
 // Breathe contracted - hands toward center (V shapes pointing in)
-const t_digit digit_breathe_contract_left = {
-  45, 135,    // V pointing right (toward center)
-  90, 90,
-  135, 45,
-  45, 135,
-  90, 90,
-  135, 45
-};
-
-const t_digit digit_breathe_contract_right = {
-  315, 225,   // V pointing left (toward center)
-  270, 270,
-  225, 315,
-  315, 225,
-  270, 270,
-  225, 315
-};
-
-// Breathe neutral - all horizontal
-const t_digit digit_breathe_neutral = {
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90
-};
-
-const t_full_clock d_breathe_expand = {digit_breathe_expand_left, digit_breathe_expand_left, digit_breathe_expand_right, digit_breathe_expand_right};
-const t_full_clock d_breathe_contract = {digit_breathe_contract_left, digit_breathe_contract_left, digit_breathe_contract_right, digit_breathe_contract_right};
-const t_full_clock d_breathe_neutral = {digit_breathe_neutral, digit_breathe_neutral, digit_breathe_neutral, digit_breathe_neutral};
+constexpr t_digit digit_breathe_contract_left = digit_sym_right;
+constexpr t_digit digit_breathe_contract_right = digit_sym_left;
 
-// ============================================
-// RAIN: Vertical falling pattern
-// Hands point down in staggered pattern
-// ============================================
+// Breathe neutral - all vertical
+constexpr t_digit digit_breathe_neutral = fill_digit(c_vertical);
 
-// Rain phase 1 - vertical lines (ready to fall)
-const t_digit digit_rain_1 = {
-  0, 180,     // vertical line |
-  0, 180,
-  0, 180,
-  0, 180,
-  0, 180,
-  0, 180
-};
-
-// Rain phase 2 - tilted (falling)
-const t_digit digit_rain_2 = {
-  315, 135,   // diagonal \
-  315, 135,
-  315, 135,
-  315, 135,
-  315, 135,
-  315, 135
-};
-
-// Rain phase 3 - horizontal (landed)
-const t_digit digit_rain_3 = {
-  270, 90,    // horizontal -
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90,
-  270, 90
-};
-
-// Rain splash - V shapes at bottom spreading out
-const t_digit digit_rain_splash = {
-  270, 90,    // top horizontal
-  270, 90,    // mid horizontal
-  225, 135,   // bottom V spread
-  270, 90,
-  270, 90,
-  315, 45     // bottom V spread (opposite)
-};
-
-const t_full_clock d_rain_1 = {digit_rain_1, digit_rain_2, digit_rain_3, digit_rain_1};
-const t_full_clock d_rain_2 = {digit_rain_2, digit_rain_3, digit_rain_1, digit_rain_2};
-const t_full_clock d_rain_3 = {digit_rain_3, digit_rain_1, digit_rain_2, digit_rain_3};
-const t_full_clock d_rain_splash = {digit_rain_splash, digit_rain_splash, digit_rain_splash, digit_rain_splash};
+constexpr t_full_clock d_breathe_expand = make_clock(digit_breathe_expand_left, digit_breathe_expand_left,
+                                                     digit_breathe_expand_right, digit_breathe_expand_right);
+constexpr t_full_clock d_breathe_contract = make_clock(digit_breathe_contract_left, digit_breathe_contract_left,
+                                                       digit_breathe_contract_right, digit_breathe_contract_right);
+constexpr t_full_clock d_breathe_neutral = fill_clock(digit_breathe_neutral);
 
 // ============================================
 // HEARTBEAT: Pulsing heart-like pattern
@@ -548,64 +401,45 @@ const t_full_clock d_rain_splash = {digit_rain_splash, digit_rain_splash, digit_
 // ============================================
 
 // Heartbeat systole (contracted) - V shapes pointing toward center
-const t_digit digit_heart_systole_left = {
-  45, 135,    // top: V pointing right >
-  270, 90,    // middle: horizontal -
-  135, 45,    // bottom: V pointing right >
-  45, 135,
-  270, 90,
-  135, 45
-};
-
-const t_digit digit_heart_systole_right = {
-  315, 225,   // top: V pointing left <
-  270, 90,    // middle: horizontal -
-  225, 315,   // bottom: V pointing left <
-  315, 225,
-  270, 90,
-  225, 315
-};
+constexpr t_digit digit_heart_systole_left = digit_ripple_in_left;
+constexpr t_digit digit_heart_systole_right = digit_ripple_in_right;
 
 // Heartbeat diastole (expanded) - V shapes pointing away from center
-const t_digit digit_heart_diastole_left = {
-  315, 225,   // top: V pointing left <
-  270, 90,    // middle: horizontal -
-  225, 315,   // bottom: V pointing left <
-  315, 225,
-  270, 90,
-  225, 315
-};
-
-const t_digit digit_heart_diastole_right = {
-  45, 135,    // top: V pointing right >
-  270, 90,    // middle: horizontal -
-  135, 45,    // bottom: V pointing right >
-  45, 135,
-  270, 90,
-  135, 45
-};
+constexpr t_digit digit_heart_diastole_left = digit_ripple_in_right;
+constexpr t_digit digit_heart_diastole_right = digit_ripple_in_left;
 
 // Heartbeat peak - dramatic outward burst (bigger V shapes)
-const t_digit digit_heart_peak_left = {
-  300, 240,   // top: wide V pointing left
-  270, 90,    // middle: horizontal
-  240, 300,   // bottom: wide V pointing left
-  300, 240,
-  270, 90,
-  240, 300
-};
-
-const t_digit digit_heart_peak_right = {
-  60, 120,    // top: wide V pointing right
-  270, 90,    // middle: horizontal
-  120, 60,    // bottom: wide V pointing right
-  60, 120,
-  270, 90,
-  120, 60
-};
-
-const t_full_clock d_heart_systole = {digit_heart_systole_left, digit_heart_systole_left, digit_heart_systole_right, digit_heart_systole_right};
-const t_full_clock d_heart_diastole = {digit_heart_diastole_left, digit_heart_diastole_left, digit_heart_diastole_right, digit_heart_diastole_right};
-const t_full_clock d_heart_peak = {digit_heart_peak_left, digit_heart_peak_left, digit_heart_peak_right, digit_heart_peak_right};
-
-#endif
\ No newline at end of file
+constexpr t_digit digit_heart_peak_left = column_digit(cell(300, 240), c_vertical, cell(240, 300));
+constexpr t_digit digit_heart_peak_right = column_digit(cell(60, 120), c_vertical, cell(120, 60));
+
+constexpr t_full_clock d_heart_systole = make_clock(digit_heart_systole_left, digit_heart_systole_left,
+                                                    digit_heart_systole_right, digit_heart_systole_right);
+constexpr t_full_clock d_heart_diastole = make_clock(digit_heart_diastole_left, digit_heart_diastole_left,
+                                                     digit_heart_diastole_right, digit_heart_diastole_right);
+constexpr t_full_clock d_heart_peak = make_clock(digit_heart_peak_left, digit_heart_peak_left,
+                                                 digit_heart_peak_right, digit_heart_peak_right);
+
+// ============================================
+// CHECKS
+// ============================================
+
+static_assert(valid_digit(digit_0) && valid_digit(digit_1) && valid_digit(digit_2) && valid_digit(digit_3) &&
+              valid_digit(digit_4) && valid_digit(digit_5) && valid_digit(digit_6) && valid_digit(digit_7) &&
+              valid_digit(digit_8) && valid_digit(digit_9), "digit angle out of range");
+static_assert(valid_clock(d_stop) && valid_clock(d_fun) && valid_clock(d_IIII), "angle out of range");
+static_assert(valid_clock(d_spin_up) && valid_clock(d_spin_down) && valid_clock(d_spin_right) &&
+              valid_clock(d_squares), "angle out of range");
+static_assert(valid_clock(d_obliques_br) && valid_clock(d_obliques_bl) && valid_clock(d_obliques_tr) &&
+              valid_clock(d_obliques_tl), "angle out of range");
+
+// Center patterns look the same from both sides
+static_assert(symmetric_clock(d_sym_diverge) && symmetric_clock(d_sym_converge), "SYMMETRICAL not symmetric");
+static_assert(symmetric_clock(d_firework), "FIREWORK not symmetric");
+static_assert(symmetric_clock(d_ripple_out) && symmetric_clock(d_ripple_in), "RIPPLE not symmetric");
+static_assert(symmetric_clock(d_breathe_expand) && symmetric_clock(d_breathe_contract) &&
+              symmetric_clock(d_breathe_neutral), "BREATHE not symmetric");
+static_assert(symmetric_clock(d_heart_systole) && symmetric_clock(d_heart_diastole) &&
+              symmetric_clock(d_heart_peak), "HEARTBEAT not symmetric");
+static_assert(symmetric_clock(d_IIII) && symmetric_clock(d_spin_up), "lines not symmetric");
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef direction_planner_h
+#define direction_planner_h
+
+#include "clock_state.h"
+
+/**
+ * Chooses the direction and the extra turns of every hand of a pose, and
+ * which hand of a clock goes to which angle (both hands look the same).
+ * The style says what is allowed, set_direction() gives the way and the
+ * minimum turns: CLOCKWISE2 = clockwise with at least one extra turn.
+ * Only MIN_DISTANCE, CLOCKWISE and COUNTERCLOCKWISE modes are planned,
+ * MAX_DISTANCE and adjustments are sent as asked.
+*/
+
+enum direction_styles
+{
+  STYLE_FIXED,      // every hand as set_direction(), hands swapped when it arrives sooner
+  STYLE_ONE_WAY,    // every hand the same way, clockwise or not, whichever ends the pose first
+  STYLE_FILL,       // pose as short as STYLE_FIXED, faster hands add turns until the slowest arrives
+  DIRECTION_STYLES
+};
+
+/**
+ * Estimates the duration of a clock move, slowest of its two hands
+ * @param from    current hands
+ * @param to      target hands, modes and speeds
+ * @return duration in milliseconds
+*/
+uint32_t estimate_clock_ms(const t_clock &from, const t_clock &to);
+
+/**
+ * Plans the modes and the hand assignment of some clocks moving together
+ * @param from    current hands of each clock
+ * @param to      target of each clock, modes set from set_direction(), changed in place
+ * @param count   number of clocks
+ * @param style   see direction_styles
+ * @return duration of the slowest clock (ms)
+*/
+uint32_t plan_directions(const t_clock *from, t_clock *to, int count, int style);
+
+#endif
@@ -4,96 +4,302 @@
 #include <WiFiUdp.h>
 #include <WiFi.h>
 #include <TimeLib.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
 
-// NTP Servers:
-static const char ntp_server_name[] = "pool.ntp.org";
-//static const char ntp_server_name[] = "time.nist.gov";
+#include "time_base.h"
+#include "timezone.h"
+#include "ntp_packet.h"
 
-int _time_zone = 1; // Central European Time
-// const int time_zone = -5;  // Eastern Standard Time (USA)
-// const int time_zone = -4;  // Eastern Daylight Time (USA)
-// const int time_zone = -8;  // Pacific Standard Time (USA)
-// const int time_zone = -7;  // Pacific Daylight Time (USA)
+// NTP Servers, queried in turn, the sample with the lowest delay wins.
+// Build with -DNTP_LOCAL_SERVER=\"192.168.1.20\" to query a LAN server first
+// (see tools/ntp_standin.py)
+static const char *ntp_server_names[] = {
+#ifdef NTP_LOCAL_SERVER
+  NTP_LOCAL_SERVER,
+#endif
+  "pool.ntp.org",
+  "time.google.com",
+  "time.cloudflare.com"
+};
+static const int ntp_server_count = sizeof(ntp_server_names) / sizeof(ntp_server_names[0]);
 
 WiFiUDP Udp;
 unsigned int local_port = 8888; // local port to listen for UDP packets
 
-const int NTP_PACKET_SIZE = 48;     // NTP time is in the first 48 bytes of message
-byte packet_buffer[NTP_PACKET_SIZE]; // buffer to hold incoming & outgoing packets
+byte packet_buffer[NTP_PACKET_SIZE]; // buffer to hold incoming packets
+byte _ntp_request[NTP_PACKET_SIZE];  // last request sent, see ntp_parse_response()
+
+#define NTP_DNS_TIMEOUT 2000          // ms
+#define NTP_RESPONSE_TIMEOUT 1000     // ms
+#define NTP_POLL_INTERVAL (30 * 60 * 1000UL)   // ms between two successful rounds
+#define NTP_RETRY_INTERVAL (60 * 1000UL)       // ms before retrying a failed round
+#define NTP_TASK_PERIOD 10                     // ms between two steps of the state machine
+#define NTP_TASK_STACK 4096
+#define NTP_REBASE_INTERVAL (60 * 60 * 1000UL) // ms, see time_base_rebase()
+
+enum ntp_states
+{
+  NTP_IDLE,
+  NTP_RESOLVING,
+  NTP_WAITING
+};
+
+int _ntp_state = NTP_IDLE;
+int _ntp_server = 0;            // server being queried in the current round
+uint32_t _ntp_state_start = 0;  // millis() when the current state was entered
+uint32_t _ntp_next_round = 0;   // millis() of the next round
+bool _ntp_running = false;
+volatile bool _ntp_sync_requested = false;
+
+volatile bool _ntp_dns_done = false;
+volatile bool _ntp_dns_found = false;
+volatile uint32_t _ntp_dns_ip = 0;
+
+int64_t _ntp_t1 = 0;            // local time of the request, ms since 1970
+t_ntp_sample _ntp_best = {false, 0, 0};
+t_ntp_sample _ntp_last = {false, 0, 0};
+uint32_t _ntp_last_sync = 0;    // millis() of the last applied sample
 
 void begin_NTP();
+void start_NTP_task();
+void ntp_loop();
 time_t get_NTP_time();
 void send_NTP_packet(IPAddress &address);
 
 void begin_NTP()
 {
   Udp.begin(local_port);
+  _ntp_running = true;
+  _ntp_state = NTP_IDLE;
+  _ntp_next_round = millis();
 }
 
+/**
+ * Time source for TimeLib, O(1) and never blocks
+ * @return local time from the time base and the time zone rule (see timezone.h),
+ *         0 if the time base is not set yet
+ */
 time_t get_NTP_time()
 {
-  IPAddress ntp_server_IP; // NTP server's ip address
-
-  while (Udp.parsePacket() > 0)
-    ; // discard any previously received packets
-  Serial.println("Transmit NTP Request");
-  // get a random server from the pool
-  WiFi.hostByName(ntp_server_name, ntp_server_IP);
-  Serial.print(ntp_server_name);
-  Serial.print(": ");
-  Serial.println(ntp_server_IP);
-  send_NTP_packet(ntp_server_IP);
-  uint32_t begin_wait = millis();
-  while (millis() - begin_wait < 1500)
+  if (!time_base_is_set())
+    return 0;
+  return tz_to_local(time_base_now());
+}
+
+// lwIP callback, runs on the tcpip task
+static void ntp_dns_found(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+  if (ipaddr != NULL)
+  {
+    _ntp_dns_ip = ip4_addr_get_u32(ip_2_ip4(ipaddr));
+    _ntp_dns_found = true;
+  }
+  _ntp_dns_done = true;
+}
+
+static void ntp_set_state(int state)
+{
+  _ntp_state = state;
+  _ntp_state_start = millis();
+}
+
+// Ends the current round: applies the best sample and schedules the next one
+static void ntp_end_round()
+{
+  _ntp_state = NTP_IDLE;
+  _ntp_server = 0;
+  if (!_ntp_best.valid)
+  {
+    Serial.println("No NTP Response :-(");
+    _ntp_next_round = millis() + NTP_RETRY_INTERVAL;
+    return;
+  }
+  Serial.printf("NTP offset: %lld ms, delay: %lld ms\n", _ntp_best.offset, _ntp_best.delay);
+  time_base_sync(_ntp_best.offset, _ntp_best.delay);
+  _ntp_last = _ntp_best;
+  _ntp_last_sync = millis();
+  _ntp_best.valid = false;
+  _ntp_next_round = millis() + NTP_POLL_INTERVAL;
+}
+
+// Moves to the next server of the round
+static void ntp_next_server()
+{
+  _ntp_server++;
+  if (_ntp_server >= ntp_server_count)
+    ntp_end_round();
+  else
+    ntp_set_state(NTP_IDLE);
+}
+
+typedef struct ntp_dns_call
+{
+  struct tcpip_api_call_data call;  // first, handed to tcpip_api_call()
+  const char *name;
+  ip_addr_t addr;
+  err_t err;
+} t_ntp_dns_call;
+
+// Runs on the tcpip task, lwIP is not thread safe
+static err_t ntp_dns_start(struct tcpip_api_call_data *data)
+{
+  t_ntp_dns_call *dns = (t_ntp_dns_call *)data;
+  dns->err = dns_gethostbyname(dns->name, &dns->addr, ntp_dns_found, NULL);
+  return ERR_OK;
+}
+
+static void ntp_start_query()
+{
+  const char *name = ntp_server_names[_ntp_server];
+  _ntp_dns_done = false;
+  _ntp_dns_found = false;
+  t_ntp_dns_call dns;
+  dns.name = name;
+  dns.err = ERR_OK;
+  tcpip_api_call(ntp_dns_start, &dns.call);
+  err_t err = dns.err;
+  if (err == ERR_OK)
+  {
+    _ntp_dns_ip = ip4_addr_get_u32(ip_2_ip4(&dns.addr));
+    _ntp_dns_found = true;
+    _ntp_dns_done = true;
+  }
+  else if (err != ERR_INPROGRESS)
+  {
+    Serial.printf("NTP: cannot resolve %s\n", name);
+    ntp_next_server();
+    return;
+  }
+  ntp_set_state(NTP_RESOLVING);
+}
+
+// Reads a response, returns true if it answers our last request
+static bool ntp_read_response()
+{
+  int size = Udp.parsePacket();
+  if (size < NTP_PACKET_SIZE)
+  {
+    if (size > 0)
+      Udp.flush();
+    return false;
+  }
+  int64_t t4 = time_base_now_ms();
+  Udp.read(packet_buffer, NTP_PACKET_SIZE);
+
+  t_ntp_sample sample = ntp_parse_response(packet_buffer, _ntp_request, _ntp_t1, t4);
+  if (!sample.valid)
+    return false;
+  Serial.printf("NTP %s: offset %lld ms, delay %lld ms\n",
+    ntp_server_names[_ntp_server], sample.offset, sample.delay);
+  if (!_ntp_best.valid || sample.delay < _ntp_best.delay)
+    _ntp_best = sample;
+  return true;
+}
+
+/**
+ * Runs one step of the NTP client state machine, called by the NTP task
+ */
+void ntp_loop()
+{
+  if (!_ntp_running)
+    return;
+  uint32_t now = millis();
+  if (_ntp_sync_requested)
+  {
+    _ntp_sync_requested = false;
+    if (_ntp_state == NTP_IDLE && _ntp_server == 0)
+      _ntp_next_round = now;
+  }
+  switch (_ntp_state)
+  {
+    case NTP_IDLE:
+      if (_ntp_server == 0 && (int32_t)(now - _ntp_next_round) < 0)
+        return;
+      if (WiFi.status() != WL_CONNECTED)
+      {
+        ntp_end_round();
+        return;
+      }
+      ntp_start_query();
+      break;
+
+    case NTP_RESOLVING:
+      if (_ntp_dns_done && _ntp_dns_found)
+      {
+        IPAddress ntp_server_IP(_ntp_dns_ip);
+        while (Udp.parsePacket() > 0)
+          ; // discard any previously received packets
+        send_NTP_packet(ntp_server_IP);
+        ntp_set_state(NTP_WAITING);
+      }
+      else if (_ntp_dns_done || now - _ntp_state_start > NTP_DNS_TIMEOUT)
+      {
+        Serial.printf("NTP: cannot resolve %s\n", ntp_server_names[_ntp_server]);
+        ntp_next_server();
+      }
+      break;
+
+    case NTP_WAITING:
+      if (ntp_read_response() || now - _ntp_state_start > NTP_RESPONSE_TIMEOUT)
+        ntp_next_server();
+      break;
+  }
+}
+
+/**
+ * Starts a new round on the next ntp_loop(), can be called from any task
+ */
+void request_NTP_sync()
+{
+  _ntp_sync_requested = true;
+}
+
+// Owns the NTP client and every time base update, the main loop only reads
+static void ntp_task(void *arg)
+{
+  uint32_t last_rebase = millis();
+  for (;;)
   {
-    int size = Udp.parsePacket();
-    if (size >= NTP_PACKET_SIZE)
+    ntp_loop();
+    if (millis() - last_rebase > NTP_REBASE_INTERVAL)
     {
-      Serial.println("Receive NTP Response");
-      Udp.read(packet_buffer, NTP_PACKET_SIZE); // read packet into the buffer
-      unsigned long secs_since_1900;
-      // convert four bytes starting at location 40 to a long integer
-      secs_since_1900 = (unsigned long)packet_buffer[40] << 24;
-      secs_since_1900 |= (unsigned long)packet_buffer[41] << 16;
-      secs_since_1900 |= (unsigned long)packet_buffer[42] << 8;
-      secs_since_1900 |= (unsigned long)packet_buffer[43];
-      return secs_since_1900 - 2208988800UL + _time_zone * SECS_PER_HOUR;
+      time_base_rebase();
+      last_rebase = millis();
     }
+    vTaskDelay(pdMS_TO_TICKS(NTP_TASK_PERIOD));
   }
-  Serial.println("No NTP Response :-(");
-  return 0; // return 0 if unable to get the time
 }
 
-// send an NTP request to the time server at the given address
-void send_NTP_packet(IPAddress &address)
+/**
+ * Starts the background task running ntp_loop(), call once after begin_NTP()
+ * (or without it when there is no network, to keep the time base rebased)
+ */
+void start_NTP_task()
 {
-  // set all bytes in the buffer to 0
-  memset(packet_buffer, 0, NTP_PACKET_SIZE);
-  // Initialize values needed to form NTP request
-  // (see URL above for details on the packets)
-  packet_buffer[0] = 0b11100011; // LI, Version, Mode
-  packet_buffer[1] = 0;          // Stratum, or type of clock
-  packet_buffer[2] = 6;          // Polling Interval
-  packet_buffer[3] = 0xEC;       // Peer Clock Precision
-  // 8 bytes of zero for Root Delay & Root Dispersion
-  packet_buffer[12] = 49;
-  packet_buffer[13] = 0x4E;
-  packet_buffer[14] = 49;
-  packet_buffer[15] = 52;
-  // all NTP fields have been given values, now
-  // you can send a packet requesting a timestamp:
-  Udp.beginPacket(address, 123); // NTP requests are to port 123
-  Udp.write(packet_buffer, NTP_PACKET_SIZE);
-  Udp.endPacket();
+  // Core 0, with the WiFi and lwIP tasks, away from the loop() task
+  xTaskCreatePinnedToCore(ntp_task, "ntp", NTP_TASK_STACK, NULL, 1, NULL, 0);
 }
 
-void set_ntp_timezone(int value)
+/**
+ * Returns the last applied sample
+ */
+t_ntp_sample get_NTP_last_sample()
 {
-  _time_zone = value;
+  return _ntp_last;
 }
 
-int get_ntp_timezone()
+// send an NTP request to the time server at the given address
+void send_NTP_packet(IPAddress &address)
 {
-  return _time_zone;
+  // Transmit timestamp (T1), echoed by the server as origin timestamp
+  _ntp_t1 = time_base_now_ms();
+  ntp_build_request(_ntp_request, _ntp_t1);
+
+  // all NTP fields have been given values, now
+  // you can send a packet requesting a timestamp:
+  Udp.beginPacket(address, 123); // NTP requests are to port 123
+  Udp.write(_ntp_request, NTP_PACKET_SIZE);
+  Udp.endPacket();
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,99 @@
+#ifndef NTP_PACKET_H
+#define NTP_PACKET_H
+
+#include <Arduino.h>
+
+/**
+ * SNTP packets and the offset/delay computation of the NTP client (ntp.h),
+ * apart from the sockets so the native tests build them as they are.
+ */
+
+#define NTP_PACKET_SIZE 48            // NTP time is in the first 48 bytes of message
+#define NTP_UNIX_OFFSET 2208988800UL  // seconds between 1900 and 1970
+
+typedef struct ntp_sample
+{
+  bool valid;
+  int64_t offset;   // ms, server time - local time
+  int64_t delay;    // ms, round trip minus server processing
+} t_ntp_sample;
+
+static uint32_t ntp_read_u32(const uint8_t *p)
+{
+  return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+static void ntp_write_u32(uint8_t *p, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    p[i] = value >> (24 - 8 * i);
+}
+
+/**
+ * Converts a 64 bit NTP timestamp (seconds since 1900, 32 bit fraction)
+ * @param timestamp   8 bytes, big endian
+ * @return ms since 1970
+ */
+int64_t ntp_to_unix_ms(const uint8_t *timestamp)
+{
+  uint32_t seconds = ntp_read_u32(timestamp);
+  uint32_t fraction = ntp_read_u32(timestamp + 4);
+  return ((int64_t)seconds - NTP_UNIX_OFFSET) * 1000 + (((uint64_t)fraction * 1000) >> 32);
+}
+
+/**
+ * Converts a time to a 64 bit NTP timestamp
+ * @param ms          ms since 1970
+ * @param timestamp   8 bytes, big endian
+ */
+void ntp_from_unix_ms(int64_t ms, uint8_t *timestamp)
+{
+  ntp_write_u32(timestamp, (uint32_t)(ms / 1000 + NTP_UNIX_OFFSET));
+  ntp_write_u32(timestamp + 4, (uint32_t)(((uint64_t)(ms % 1000) << 32) / 1000));
+}
+
+/**
+ * Fills a client request
+ * @param packet    NTP_PACKET_SIZE bytes
+ * @param t1        local time of the request, ms since 1970, sent as transmit
+ *                  timestamp and echoed by the server as origin timestamp
+ */
+void ntp_build_request(uint8_t *packet, int64_t t1)
+{
+  memset(packet, 0, NTP_PACKET_SIZE);
+  packet[0] = 0b11100011; // LI, Version, Mode
+  packet[1] = 0;          // Stratum, or type of clock
+  packet[2] = 6;          // Polling Interval
+  packet[3] = 0xEC;       // Peer Clock Precision
+  // 8 bytes of zero for Root Delay & Root Dispersion
+  packet[12] = 49;
+  packet[13] = 0x4E;
+  packet[14] = 49;
+  packet[15] = 52;
+  ntp_from_unix_ms(t1, packet + 40);
+}
+
+/**
+ * Checks a server answer and computes the sample,
+ * RFC 5905: offset = ((T2 - T1) + (T3 - T4)) / 2, delay = (T4 - T1) - (T3 - T2)
+ * @param packet    NTP_PACKET_SIZE bytes received
+ * @param request   NTP_PACKET_SIZE bytes of the request sent
+ * @param t1        local time of the request (ms since 1970)
+ * @param t4        local time of the answer (ms since 1970)
+ * @return sample, not valid if the packet doesn't answer the request
+ */
+t_ntp_sample ntp_parse_response(const uint8_t *packet, const uint8_t *request, int64_t t1, int64_t t4)
+{
+  t_ntp_sample sample = {false, 0, 0};
+  // Origin timestamp must echo our transmit timestamp, stratum 0 is a kiss-o'-death
+  if (memcmp(packet + 24, request + 40, 8) != 0 || packet[1] == 0)
+    return sample;
+  int64_t t2 = ntp_to_unix_ms(packet + 32);
+  int64_t t3 = ntp_to_unix_ms(packet + 40);
+  sample.valid = true;
+  sample.offset = ((t2 - t1) + (t3 - t4)) / 2;
+  sample.delay = max((int64_t)0, (t4 - t1) - (t3 - t2));
+  return sample;
+}
+
+#endif
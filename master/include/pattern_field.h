@@ -0,0 +1,78 @@
+#ifndef pattern_field_h
+#define pattern_field_h
+
+#include "clock_state.h"
+
+/**
+ * Patterns computed instead of stored: a field gives the hands of every clock
+ * from its place on the 8x3 grid (see docs/CHOREOGRAPHIES.md) and the time.
+ * Angles follow the digit tables: digit_0's top left corner is cell(270, 0),
+ * so 0 points right and angles grow counterclockwise (90 up, 180 left).
+ * Fields return small steps between frames, play them with MIN_DISTANCE.
+*/
+
+#define FIELD_COLUMNS 8
+#define FIELD_ROWS 3
+// Fixed point unit of field_sin(), field_cos() and field_noise()
+#define FIELD_ONE 1024
+
+/**
+ * Pattern function
+ * @param col     column, 0 (left) to 7
+ * @param row     row, 0 (top) to 2
+ * @param t       ms since the pattern started
+ * @return hands angles of the clock
+*/
+typedef t_clockl (*t_field)(int col, int row, uint32_t t);
+
+/**
+ * Wraps an angle to 0..359
+ * @param angle   degrees, any sign
+ * @return degrees
+*/
+uint16_t field_angle(int32_t angle);
+
+/**
+ * Sine from the lookup table
+ * @param angle   degrees, any sign
+ * @return -FIELD_ONE..FIELD_ONE
+*/
+int16_t field_sin(int32_t angle);
+
+/**
+ * Cosine from the lookup table
+ * @param angle   degrees, any sign
+ * @return -FIELD_ONE..FIELD_ONE
+*/
+int16_t field_cos(int32_t angle);
+
+/**
+ * Position in a repeating cycle
+ * @param t         ms since the pattern started
+ * @param period    ms per cycle
+ * @return degrees (0..359)
+*/
+uint16_t field_phase(uint32_t t, uint32_t period);
+
+/**
+ * Travelling sine wave
+ * @param position      distance along the wave, in clocks (column or row)
+ * @param t             ms since the pattern started
+ * @param period        ms for the wave to pass one point
+ * @param wavelength    clocks between two crests
+ * @param amplitude     value at the crests
+ * @return -amplitude..amplitude, the wave moves towards increasing positions
+*/
+int32_t field_wave(int position, uint32_t t, uint32_t period, int wavelength, int32_t amplitude);
+
+/**
+ * Smooth pseudo random value, the same for the same clock and time
+ * @param col       column, 0 (left) to 7
+ * @param row       row, 0 (top) to 2
+ * @param t         ms since the pattern started
+ * @param period    ms between two independent values
+ * @return -FIELD_ONE..FIELD_ONE
+*/
+int32_t field_noise(int col, int row, uint32_t t, uint32_t period);
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef pose_h
+#define pose_h
+
+#include "clock_state.h"
+
+/**
+ * A pose is the 48 hand angles of the clock, one flat array ordered board by
+ * board (= column, left to right), top clock first, hour hand first:
+ * h0, m0, h1, m1, h2, m2 of column 0, then column 1...
+ * Same order as the UDP frames. Columns and clocks are read and written
+ * through pose_column() and pose_set_clock(), the speeds, modes and change
+ * counters of the wire format are only added when a board frame is sent.
+*/
+
+#define POSE_COLUMNS 8
+#define POSE_ROWS 3
+#define POSE_CLOCKS (POSE_COLUMNS * POSE_ROWS)
+#define POSE_HANDS (POSE_CLOCKS * 2)
+
+enum pose_hands
+{
+  HAND_H,
+  HAND_M
+};
+
+typedef struct pose
+{
+  uint16_t angle[POSE_HANDS];   // see pose_index()
+} t_pose;
+
+/**
+ * Index of a hand in t_pose::angle
+ * @param col     column, 0 (left) to 7, same as the board index
+ * @param row     row, 0 (top) to 2
+ * @param hand    HAND_H or HAND_M
+*/
+constexpr int pose_index(int col, int row, int hand)
+{
+  return (col * POSE_ROWS + row) * 2 + hand;
+}
+
+/**
+ * Gets the clocks of a column, as sent to its board
+ * @param pose    pose
+ * @param col     column, 0 (left) to 7, same as the board index
+ * @return half digit
+*/
+t_half_digitl pose_column(const t_pose &pose, int col);
+
+/**
+ * Sets the hands of a clock
+ * @param pose    pose
+ * @param col     column, 0 (left) to 7
+ * @param row     row, 0 (top) to 2
+ * @param clock   hand angles
+*/
+void pose_set_clock(t_pose &pose, int col, int row, const t_clockl &clock);
+
+/**
+ * Copies a pattern into a pose
+ * @param clock   full clock, e.g. a pattern of digit.h
+ * @return pose
+*/
+t_pose pose_from_clock(const t_full_clock &clock);
+
+/**
+ * Clocks whose hands differ between two poses, a clock with its two hands
+ * swapped shows the same picture and is not counted
+ * @param a   first pose
+ * @param b   second pose
+ * @return bitmask, bit = col * POSE_ROWS + row
+*/
+uint32_t pose_diff(const t_pose &a, const t_pose &b);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef POSE_FRAME_H
+#define POSE_FRAME_H
+
+#include <Arduino.h>
+
+/**
+ * Pose frames of the UDP stream (see docs/UDP_CONTROL.md) and their drop
+ * rules, apart from the socket so the native tests build them as they are.
+ */
+
+#define UDP_POSE_MAGIC 0x34324343  // "CC24" little endian
+#define UDP_MAX_FRAME_AGE 250      // ms, frames older than this are dropped
+
+#define POSE_FLAG_RESET 0x01       // sender restarted, reset sequence tracking
+
+enum pose_ack_status
+{
+  POSE_APPLIED,
+  POSE_DROPPED_OLD,
+  POSE_DROPPED_LATE,
+  POSE_SUPERSEDED
+};
+
+typedef struct __attribute__((packed)) pose_frame
+{
+  uint32_t magic;
+  uint32_t sequence;
+  uint32_t sent_ms;       // sender clock, echoed back in the ack
+  uint16_t speed;
+  uint16_t accel;
+  uint8_t direction;
+  uint8_t flags;
+  uint16_t angles[48];    // clock i (see docs/CHOREOGRAPHIES.md): [2i] = h, [2i+1] = m
+} t_pose_frame;
+
+typedef struct __attribute__((packed)) pose_ack
+{
+  uint32_t magic;
+  uint32_t sequence;
+  uint32_t sent_ms;
+  uint8_t status;
+} t_pose_ack;
+
+bool _udp_has_sequence = false;
+uint32_t _udp_last_sequence = 0;
+// Minimum (local - sender) clock difference seen, i.e. the fastest frame
+bool _udp_has_offset = false;
+int32_t _udp_min_offset = 0;
+
+/**
+ * Checks sequence and age of a frame
+ * @param frame   received frame
+ * @param now     local time in ms
+ * @return POSE_APPLIED if the frame can be used, drop reason otherwise
+ */
+uint8_t check_pose_frame(const t_pose_frame &frame, uint32_t now)
+{
+  if (frame.flags & POSE_FLAG_RESET)
+  {
+    _udp_has_sequence = false;
+    _udp_has_offset = false;
+  }
+  if (_udp_has_sequence && (int32_t)(frame.sequence - _udp_last_sequence) <= 0)
+    return POSE_DROPPED_OLD;
+
+  int32_t offset = (int32_t)(now - frame.sent_ms);
+  if (!_udp_has_offset || offset < _udp_min_offset)
+  {
+    _udp_min_offset = offset;
+    _udp_has_offset = true;
+  }
+  _udp_has_sequence = true;
+  _udp_last_sequence = frame.sequence;
+  if (offset - _udp_min_offset > UDP_MAX_FRAME_AGE)
+    return POSE_DROPPED_LATE;
+  return POSE_APPLIED;
+}
+
+#endif
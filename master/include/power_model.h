@@ -0,0 +1,63 @@
+#ifndef power_model_h
+#define power_model_h
+
+#include <Arduino.h>
+
+/**
+ * Supply current of the motors, to keep the moves started together under
+ * the power budget (see set_power_budget()). A hand draws MOTOR_HOLD_MA at
+ * rest, MOTOR_RUN_MA at cruise speed and more while its speed changes,
+ * MOTOR_ACCEL_MA at POWER_ACCEL_REF and in proportion to the acceleration.
+ * Figures are for the default TMC_RUN_CURRENT of the slaves at 12 V.
+*/
+
+#define MOTOR_HOLD_MA 40
+#define MOTOR_RUN_MA 120
+#define MOTOR_ACCEL_MA 180
+#define POWER_ACCEL_REF 300       // steps/sec^2
+#define POWER_HANDS 48
+// The slaves slow down the faster hand of a dial so both arrive together
+// (COORDINATE_HANDS == COORDINATE_DIAL in slave/include/board_config.h)
+#define POWER_COORDINATED_DIALS true
+
+typedef struct power_move
+{
+  uint32_t start;       // millis() of the first step
+  uint32_t ramp;        // ms to reach the cruise speed, the same to stop
+  uint32_t duration;    // ms from the first step to the last one
+  uint16_t accel_ma;    // extra current while ramping
+} t_power_move;
+
+/**
+ * Models a hand move with the trapezoidal profile of estimate_move_ms()
+ * @param degrees   travel in degrees
+ * @param speed     max speed (steps/sec)
+ * @param accel     acceleration (steps/sec^2)
+ * @param start     millis() of the first step
+ * @param arrive    ms the move is stretched to, speed and acceleration
+ *                  scaled together as the slaves do, 0 to keep its pace
+ * @return move, zero duration if the hand doesn't move
+*/
+t_power_move plan_power_move(int degrees, int speed, int accel, uint32_t start, uint32_t arrive);
+
+/**
+ * Supply current of some hands at a given time
+ * @param moves   last move of each hand
+ * @param count   number of hands
+ * @param t       millis()
+ * @return mA
+*/
+uint32_t power_load_at(const t_power_move *moves, int count, uint32_t t);
+
+/**
+ * Highest supply current of some hands over a time window, the load only
+ * changes when a move starts, ends or reaches its cruise speed
+ * @param moves   last move of each hand
+ * @param count   number of hands
+ * @param from    millis(), window start
+ * @param to      millis(), window end
+ * @return mA
+*/
+uint32_t power_peak_between(const t_power_move *moves, int count, uint32_t from, uint32_t to);
+
+#endif
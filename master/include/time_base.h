@@ -0,0 +1,107 @@
+#ifndef TIME_BASE_H
+#define TIME_BASE_H
+
+#include <Arduino.h>
+
+// Offsets bigger than this are stepped, smaller ones are slewed (ms, RFC 5905)
+#define TIME_STEP_THRESHOLD 128
+// Slew speed: 1 ms of correction every TIME_SLEW_RATIO ms
+#define TIME_SLEW_RATIO 20
+// Number of sync samples kept for diagnostics
+#define TIME_HISTORY_SIZE 8
+// Samples closer than this don't update the drift estimate (ms)
+#define TIME_DRIFT_MIN_INTERVAL (10 * 60 * 1000UL)
+// Drift estimates beyond this are rejected as time jumps (ppb)
+#define TIME_DRIFT_MAX 500000
+// Drift uncertainty before the first estimate, and its lower bound (ppb)
+#define TIME_DRIFT_UNKNOWN 50000
+#define TIME_DRIFT_FLOOR 1000
+
+// Reads are lock free for the caller and never change the time base, they can
+// run on any task. Set, adjust and rebase are atomic too, sync keeps its
+// history and drift estimate for one task at a time.
+
+typedef struct time_sample
+{
+  int64_t epoch_ms;   // UTC time of the sample
+  int32_t offset;     // ms, measured correction
+  int32_t delay;      // ms, round trip of the sample
+} t_time_sample;
+
+/**
+ * Checks if the time base has been set at least once
+ * @return true if the time is known, false otherwise
+*/
+bool time_base_is_set();
+
+/**
+ * Returns current UTC time, O(1) and never blocks
+ * @return milliseconds since 1970-01-01
+*/
+int64_t time_base_now_ms();
+
+/**
+ * Returns current UTC time
+ * @return seconds since 1970-01-01
+*/
+time_t time_base_now();
+
+/**
+ * Folds the elapsed time into the base, keeps reads correct across the
+ * millis() rollover: call at least once a day
+*/
+void time_base_rebase();
+
+/**
+ * Sets the UTC time immediately
+ * @param epoch_ms    milliseconds since 1970-01-01
+*/
+void time_base_set(int64_t epoch_ms);
+
+/**
+ * Corrects the time, stepping big offsets and slewing small ones
+ * @param offset_ms   correction to apply (> 0 clock is late)
+*/
+void time_base_adjust(int64_t offset_ms);
+
+/**
+ * Applies a sync sample: corrects the time and refines the drift estimate
+ * used while no sample is available
+ * @param offset_ms   measured correction (> 0 clock is late)
+ * @param delay_ms    round trip of the sample, bounds its error
+*/
+void time_base_sync(int64_t offset_ms, int64_t delay_ms);
+
+/**
+ * Returns the estimated oscillator drift, already compensated
+ * @return parts per billion (> 0 local oscillator is slow)
+*/
+int32_t time_base_drift_ppb();
+
+/**
+ * Returns the time since the last sync sample
+ * @return seconds, -1 if never synced
+*/
+int32_t time_base_sync_age();
+
+/**
+ * Returns the estimated error of the current time
+ * @return milliseconds, -1 if never synced
+*/
+int32_t time_base_error_estimate();
+
+/**
+ * Copies the last sync samples
+ * @param samples   destination, newest first
+ * @param max       size of the destination
+ * @return number of samples copied
+*/
+int time_base_history(t_time_sample *samples, int max);
+
+/**
+ * Returns the correction still to be slewed
+ * @return milliseconds
+*/
+int32_t time_base_pending_slew();
+
+#endif
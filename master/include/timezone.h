@@ -0,0 +1,45 @@
+#ifndef TIMEZONE_H
+#define TIMEZONE_H
+
+#include <Arduino.h>
+
+/**
+ * Sets the time zone rule
+ * @param rule    POSIX TZ string (e.g. "CET-1CEST,M3.5.0,M10.5.0/3")
+ *                or a zone name from the built-in table (e.g. "Europe/Paris")
+ * @return true if the rule is valid, false otherwise (previous rule kept)
+*/
+bool tz_set(const char *rule);
+
+/**
+ * Sets a fixed offset with no daylight saving time
+ * @param minutes   UTC offset in minutes (e.g. 330 for UTC+5:30)
+*/
+void tz_set_fixed(int minutes);
+
+/**
+ * Gets the current rule
+ * @return POSIX TZ string
+*/
+const char *tz_get();
+
+/**
+ * Checks if the current rule has daylight saving time
+*/
+bool tz_has_dst();
+
+/**
+ * Returns the UTC offset at a given instant, O(1) for successive calls
+ * @param utc   seconds since 1970-01-01 UTC
+ * @return offset in seconds (local = utc + offset)
+*/
+int32_t tz_offset_at(time_t utc);
+
+/**
+ * Converts UTC to local time
+ * @param utc   seconds since 1970-01-01 UTC
+ * @return local seconds since 1970-01-01
+*/
+time_t tz_to_local(time_t utc);
+
+#endif
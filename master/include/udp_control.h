@@ -0,0 +1,137 @@
+#ifndef UDP_CONTROL_H
+#define UDP_CONTROL_H
+
+#include <WiFiUdp.h>
+#include <WiFi.h>
+
+#include "clock_manager.h"
+#include "pose_frame.h"
+
+/**
+ * Real-time pose streaming from a LAN host (show-control PC).
+ * See docs/UDP_CONTROL.md for the frame format and tools/pose_sender.py
+ * for the reference sender.
+ */
+
+#define UDP_CONTROL_PORT 4210
+#define UDP_STREAM_TIMEOUT 5000    // ms without frames before the clock shows time again
+
+typedef struct udp_control_stats
+{
+  uint32_t received;
+  uint32_t applied;
+  uint32_t dropped_old;
+  uint32_t dropped_late;
+  uint32_t superseded;
+  uint32_t malformed;
+} t_udp_control_stats;
+
+WiFiUDP _control_udp;
+t_udp_control_stats _udp_stats = {0};
+
+uint32_t _udp_last_frame_ms = 0;
+
+/**
+ * Starts listening for pose frames
+ */
+void begin_udp_control()
+{
+  _control_udp.begin(UDP_CONTROL_PORT);
+  Serial.printf("UDP control listening on port %d\n", UDP_CONTROL_PORT);
+}
+
+/**
+ * Acknowledges a frame so the sender can measure latency and loss
+ * @param frame   received frame
+ * @param status  one of pose_ack_status
+ */
+void send_pose_ack(const t_pose_frame &frame, uint8_t status)
+{
+  t_pose_ack ack = {UDP_POSE_MAGIC, frame.sequence, frame.sent_ms, status};
+  _control_udp.beginPacket(_control_udp.remoteIP(), _control_udp.remotePort());
+  _control_udp.write((const uint8_t *)&ack, sizeof(ack));
+  _control_udp.endPacket();
+}
+
+/**
+ * Forwards a pose to the boards
+ * @param frame   frame to apply
+ */
+void apply_pose_frame(const t_pose_frame &frame)
+{
+  // Same order as t_pose
+  t_pose pose;
+  for (int i = 0; i < POSE_HANDS; i++)
+    pose.angle[i] = frame.angles[i] % 360;
+  set_speed(frame.speed);
+  set_acceleration(frame.accel);
+  set_direction(frame.direction <= MAX_DISTANCE3 ? frame.direction : MIN_DISTANCE);
+  set_pose(pose);
+}
+
+/**
+ * Reads all pending frames and applies the newest valid one,
+ * needs to be called on the main loop
+ */
+void handle_udp_control()
+{
+  t_pose_frame frame;
+  t_pose_frame pending;
+  bool has_pending = false;
+
+  while (_control_udp.parsePacket() > 0)
+  {
+    int size = _control_udp.read((uint8_t *)&frame, sizeof(frame));
+    _udp_stats.received++;
+    if (size != sizeof(frame) || frame.magic != UDP_POSE_MAGIC)
+    {
+      _udp_stats.malformed++;
+      continue;
+    }
+    uint8_t status = check_pose_frame(frame, millis());
+    if (status == POSE_APPLIED)
+    {
+      // Only the newest frame of a burst reaches the boards
+      if (has_pending)
+      {
+        _udp_stats.superseded++;
+        send_pose_ack(pending, POSE_SUPERSEDED);
+      }
+      pending = frame;
+      has_pending = true;
+      continue;
+    }
+    if (status == POSE_DROPPED_OLD)
+      _udp_stats.dropped_old++;
+    else
+      _udp_stats.dropped_late++;
+    send_pose_ack(frame, status);
+  }
+
+  if (has_pending)
+  {
+    apply_pose_frame(pending);
+    _udp_stats.applied++;
+    _udp_last_frame_ms = millis();
+    send_pose_ack(pending, POSE_APPLIED);
+  }
+}
+
+/**
+ * Check if a host is currently streaming poses
+ * @return true if a frame was applied recently, false otherwise
+ */
+bool is_udp_streaming()
+{
+  return _udp_stats.applied > 0 && millis() - _udp_last_frame_ms < UDP_STREAM_TIMEOUT;
+}
+
+/**
+ * Returns the streaming counters
+ */
+t_udp_control_stats get_udp_control_stats()
+{
+  return _udp_stats;
+}
+
+#endif
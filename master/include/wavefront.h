@@ -0,0 +1,52 @@
+#ifndef wavefront_h
+#define wavefront_h
+
+#include <Arduino.h>
+
+/**
+ * Staggered reveals: a target pose reaches the clocks in waves, the order
+ * says which clocks go first, the easing how the waves are spread in time.
+*/
+
+// At most one step per clock
+#define WAVE_MAX_STEPS 24
+
+enum wave_orders
+{
+  WAVE_CENTER_OUT,    // columns 3,4 then 2,5, 1,6 and 0,7
+  WAVE_EDGES_IN,      // columns 0,7 first, 3,4 last
+  WAVE_LEFT_RIGHT,
+  WAVE_RIGHT_LEFT,
+  WAVE_DIAGONAL,      // top left clock first, bottom right last
+  WAVE_ROWS,          // top row first
+  WAVE_RANDOM,        // one column at a time, random order
+  WAVE_ORDERS
+};
+
+enum wave_easings
+{
+  EASE_LINEAR,        // same delay between waves
+  EASE_IN,            // slow start, delays shrink
+  EASE_OUT,           // slow end, delays grow
+  EASE_IN_OUT,        // slow at both ends
+  WAVE_EASINGS
+};
+
+typedef struct wave_step
+{
+  uint32_t at;        // ms after the first step
+  uint8_t board;      // board index (0 <= board < 8), same as the column
+  uint8_t clocks;     // bitmask of the clocks of the board to move (bit = row)
+} t_wave_step;
+
+/**
+ * Plans the waves
+ * @param order       see wave_orders
+ * @param easing      see wave_easings
+ * @param duration    ms from the first to the last wave
+ * @param steps       result, sorted by time
+ * @return number of steps
+*/
+int plan_wave(int order, int easing, uint32_t duration, t_wave_step steps[WAVE_MAX_STEPS]);
+
+#endif
@@ -8,16 +8,6 @@
 #include "clock_manager.h"
 #include "clock_config.h"
 
-typedef struct browser_time
-{
-  int hour;
-  int minute;
-  int second;
-  int day;
-  int month;
-  int year;
-} t_browser_time;
-
 /**
  * Starts and configures the server
 */
@@ -103,6 +93,16 @@ void handle_api_drivers_enable();
 */
 void handle_api_drivers_disable();
 
+/**
+ * Handles POST /api/home
+*/
+void handle_api_home();
+
+/**
+ * Handles GET /api/home
+*/
+void handle_api_home_status();
+
 /**
  * Handles POST /api/stop
 */
@@ -120,10 +120,17 @@ void handle_api_motor_position();
 */
 bool is_time_changed_browser();
 
+/**
+ * Tells the server whether the access point is open as a fallback, the page
+ * then shows the hotspot mode the clock is actually in
+ * @param active    true while the fallback access point is open
+*/
+void set_ap_fallback(bool active);
+
 /**
  * Return the client's browser time
- * @return time
+ * @return UTC time in ms since 1970
 */
-t_browser_time get_browser_time();
+int64_t get_browser_time();
 
 #endif
\ No newline at end of file
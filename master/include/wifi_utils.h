@@ -6,46 +6,155 @@
 #include <ESPmDNS.h>
 
 Adafruit_NeoPixel pixels(NUMPIXELS, PIN_RGB, NEO_GRB + NEO_KHZ800);
-const int max_wifi_retries = 50;
+
+#define WIFI_CONNECT_TIMEOUT 15000       // ms for one connection attempt
+#define WIFI_MIN_BACKOFF 1000            // ms before the first retry
+#define WIFI_MAX_BACKOFF (5 * 60 * 1000UL) // ms, backoff is doubled up to this
+#define WIFI_AP_FALLBACK_ATTEMPTS 2      // failed attempts before opening the access point
+
+enum wifi_manager_states
+{
+  WIFI_MGR_IDLE,
+  WIFI_MGR_CONNECTING,
+  WIFI_MGR_CONNECTED,
+  WIFI_MGR_BACKOFF
+};
+
+int _wifi_state = WIFI_MGR_IDLE;
+const char *_wifi_ssid = NULL;
+const char *_wifi_password = NULL;
+const char *_wifi_mdns = NULL;
+const char *_wifi_ap_ssid = NULL;
+uint32_t _wifi_state_start = 0;   // millis() when the current state was entered
+uint32_t _wifi_backoff = WIFI_MIN_BACKOFF;
+int _wifi_failures = 0;           // failed attempts since the last connection
+bool _wifi_ap_fallback = false;   // access point opened because the network is unreachable
+bool _mdns_started = false;
+
+// Set from the WiFi event task, consumed by wifi_loop()
+volatile bool _wifi_got_ip = false;
+volatile bool _wifi_lost = false;
+
+bool wifi_create_AP(const char *ssid, const char *mdns);
+void set_wifi_status_led(int mode);
+
+static void wifi_event(arduino_event_id_t event, arduino_event_info_t info)
+{
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+    _wifi_got_ip = true;
+  else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+    _wifi_lost = true;
+}
+
+static void wifi_set_state(int state)
+{
+  _wifi_state = state;
+  _wifi_state_start = millis();
+}
+
+static void wifi_start_attempt()
+{
+  _wifi_got_ip = false;
+  _wifi_lost = false;
+  WiFi.disconnect();
+  WiFi.begin(_wifi_ssid, _wifi_password);
+  wifi_set_state(WIFI_MGR_CONNECTING);
+}
 
 /**
- * Connects to a wifi network
+ * Starts connecting to a wifi network in background, see wifi_loop()
  * @param ssid      access point SSID
  * @param password  access point password
  * @param mdns      mdns host name
- * @return true if successful, false otherwise
+ * @param ap_ssid   SSID of the fallback access point
 */
-bool wifi_connect(const char *ssid, const char *password, const char *mdns)
+void wifi_begin(const char *ssid, const char *password, const char *mdns, const char *ap_ssid)
 {
   Serial.printf("\nConnecting to %s\n", ssid);
+  _wifi_ssid = ssid;
+  _wifi_password = password;
+  _wifi_mdns = mdns;
+  _wifi_ap_ssid = ap_ssid;
+  _wifi_failures = 0;
+  _wifi_backoff = WIFI_MIN_BACKOFF;
 
+  WiFi.onEvent(wifi_event);
   WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid, password);
+  // Retries are scheduled here, with backoff
+  WiFi.setAutoReconnect(false);
+  wifi_start_attempt();
+  set_wifi_status_led(-1);
+}
 
-  int i = max_wifi_retries;
-  while (WiFi.status() != WL_CONNECTED && i-- > 0)
-  {
-    delay(200);
-    Serial.print(".");
-    delay(200);
-  }
-  if (WiFi.status() != WL_CONNECTED)
-  {
-    Serial.printf("\nWiFi not connected: max wifi retries reached\n");
-    return false;
-  }
-  if (!MDNS.begin(mdns)) 
-  { // Start the mDNS responder for clockclok24.local
-    Serial.println("Error setting up MDNS responder!");
-  } 
-  else 
+/**
+ * Runs the connection state machine, needs to be called on the main loop
+ * @return true when the connection has just been (re)established
+*/
+bool wifi_loop()
+{
+  uint32_t now = millis();
+  switch (_wifi_state)
   {
-    MDNS.addService("http", "tcp", 80);
+    case WIFI_MGR_IDLE:
+      break;
+
+    case WIFI_MGR_CONNECTING:
+      if (_wifi_got_ip || WiFi.status() == WL_CONNECTED)
+      {
+        wifi_set_state(WIFI_MGR_CONNECTED);
+        _wifi_failures = 0;
+        _wifi_backoff = WIFI_MIN_BACKOFF;
+        _wifi_lost = false;
+        if (_wifi_ap_fallback)
+        {
+          Serial.println("Network is back, closing access point");
+          WiFi.softAPdisconnect(true);
+          WiFi.mode(WIFI_STA);
+          _wifi_ap_fallback = false;
+        }
+        Serial.println("WiFi connected");
+        Serial.println("IP address: " + WiFi.localIP().toString());
+        set_wifi_status_led(EXT_CONN);
+        return true;
+      }
+      if (now - _wifi_state_start > WIFI_CONNECT_TIMEOUT)
+      {
+        _wifi_failures++;
+        Serial.printf("WiFi not connected (attempt %d), retrying in %lu ms\n",
+          _wifi_failures, (unsigned long)_wifi_backoff);
+        WiFi.disconnect();
+        if (!_wifi_ap_fallback && _wifi_failures >= WIFI_AP_FALLBACK_ATTEMPTS)
+        {
+          // Keep trying in station mode while the web page is reachable
+          WiFi.mode(WIFI_AP_STA);
+          _wifi_ap_fallback = wifi_create_AP(_wifi_ap_ssid, _wifi_mdns);
+          _mdns_started = _wifi_ap_fallback;
+          set_wifi_status_led(HOTSPOT);
+        }
+        wifi_set_state(WIFI_MGR_BACKOFF);
+      }
+      break;
+
+    case WIFI_MGR_CONNECTED:
+      if (_wifi_lost && WiFi.status() != WL_CONNECTED)
+      {
+        Serial.println("WiFi connection lost");
+        _wifi_backoff = WIFI_MIN_BACKOFF;
+        set_wifi_status_led(-1);
+        wifi_set_state(WIFI_MGR_BACKOFF);
+      }
+      _wifi_lost = false;
+      break;
+
+    case WIFI_MGR_BACKOFF:
+      if (now - _wifi_state_start >= _wifi_backoff)
+      {
+        _wifi_backoff = min(_wifi_backoff * 2, (uint32_t)WIFI_MAX_BACKOFF);
+        wifi_start_attempt();
+      }
+      break;
   }
-  Serial.println("WiFi connected");
-  Serial.println("mDNS started: http://clockclock24.local");
-  Serial.println("IP address: " + WiFi.localIP().toString());
-  return true;
+  return false;
 }
 
 /**
@@ -68,13 +177,15 @@ bool wifi_create_AP(const char *ssid, const char *mdns)
   }
   WiFi.softAP(ssid, NULL);
   IPAddress IP = WiFi.softAPIP();
-  if (!MDNS.begin(mdns)) 
+  _wifi_mdns = mdns;
+  if (!_mdns_started && !MDNS.begin(mdns)) 
   { // Start the mDNS responder
     Serial.println("Error setting up MDNS responder!");
   }
-  else 
+  else if (!_mdns_started)
   {
     MDNS.addService("http", "tcp", 80);
+    _mdns_started = true;
   }
   Serial.printf("mDNS started: http://%s.local\n", mdns);
   Serial.println("IP address: " + AP_LOCAL_IP.toString());
@@ -83,11 +194,20 @@ bool wifi_create_AP(const char *ssid, const char *mdns)
 }
 
 /**
- * Update MDNS service
+ * Update MDNS service, starts the responder once an interface is up
 */
 void update_MDNS()
 {
-
+  if (_mdns_started || _wifi_mdns == NULL || _wifi_state != WIFI_MGR_CONNECTED)
+    return;
+  _mdns_started = true;
+  if (!MDNS.begin(_wifi_mdns))
+  { // Start the mDNS responder for clockclok24.local
+    Serial.println("Error setting up MDNS responder!");
+    return;
+  }
+  MDNS.addService("http", "tcp", 80);
+  Serial.printf("mDNS started: http://%s.local\n", _wifi_mdns);
 }
 
 /**
@@ -99,6 +219,15 @@ bool is_connected()
   return WiFi.status() == WL_CONNECTED;
 }
 
+/**
+ * Check if the access point is open because the network is unreachable
+ * @return true while the fallback access point is open, false otherwise
+*/
+bool is_ap_fallback()
+{
+  return _wifi_ap_fallback;
+}
+
 /**
  * Set statut LED color to indicate wifi status
 */
@@ -240,6 +240,7 @@ static uint32_t nextSyncTime = 0;
 static timeStatus_t Status = timeNotSet;
 
 getExternalTime getTimePtr;  // pointer to external sync function
+static getExternalTime timeSourcePtr = 0;  // when set, now() reads it and never syncs
 //setExternalTime setTimePtr; // not used in this version
 
 #ifdef TIME_DRIFT_INFO   // define this to get drift data
@@ -248,6 +249,8 @@ time_t sysUnsyncedTime = 0; // the time sysTime unadjusted by sync
 
 
 time_t now() {
+  if (timeSourcePtr != 0)
+    return timeSourcePtr();
 	// calculate number of seconds passed since last call to now()
   while (millis() - prevMillis >= 1000) {
 		// millis() and prevMillis are both unsigned ints thus the subtraction will always be the absolute value of the difference
@@ -305,6 +308,8 @@ void adjustTime(long adjustment) {
 
 // indicates if time has been set and recently synchronized
 timeStatus_t timeStatus() {
+  if (timeSourcePtr != 0)
+    return timeSourcePtr() != 0 ? timeSet : timeNotSet;
   now(); // required to actually update the status
   return Status;
 }
@@ -315,6 +320,10 @@ void setSyncProvider( getExternalTime getTimeFunction){
   now(); // this will sync the clock
 }
 
+void setTimeSource( getExternalTime getTimeFunction){
+  timeSourcePtr = getTimeFunction;
+}
+
 void setSyncInterval(time_t interval){ // set the number of seconds between re-sync
   syncInterval = (uint32_t)interval;
   nextSyncTime = sysTime + syncInterval;
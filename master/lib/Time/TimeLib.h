@@ -133,6 +133,7 @@ char* dayShortStr(uint8_t day);
 timeStatus_t timeStatus(); // indicates if time has been set and recently synchronized
 void    setSyncProvider( getExternalTime getTimeFunction); // identify the external time provider
 void    setSyncInterval(time_t interval); // set the number of seconds between re-sync
+void    setTimeSource( getExternalTime getTimeFunction); // now() returns the source directly, 0 = time not set
 
 /* low level functions to convert to and from system time                     */
 void breakTime(time_t time, tmElements_t &tm);  // break time_t into elements
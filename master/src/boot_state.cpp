@@ -0,0 +1,49 @@
+#include "boot_state.h"
+#include <stddef.h>
+#include <esp_system.h>
+
+// Not cleared by the startup code
+RTC_NOINIT_ATTR t_boot_state _boot_state;
+bool _warm_boot = false;
+
+static uint32_t boot_state_crc()
+{
+  // FNV-1a, cheap enough to run on every pose change
+  const uint8_t *data = (const uint8_t *)&_boot_state;
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < offsetof(t_boot_state, crc); i++)
+    hash = (hash ^ data[i]) * 16777619u;
+  return hash;
+}
+
+bool begin_boot_state()
+{
+  esp_reset_reason_t reason = esp_reset_reason();
+  _warm_boot = reason != ESP_RST_POWERON && reason != ESP_RST_BROWNOUT &&
+               _boot_state.magic == BOOT_STATE_MAGIC && _boot_state.crc == boot_state_crc();
+  if (!_warm_boot)
+  {
+    memset(&_boot_state, 0, sizeof(_boot_state));
+    _boot_state.magic = BOOT_STATE_MAGIC;
+    _boot_state.hour = -1;
+    _boot_state.minute = -1;
+    save_boot_state();
+  }
+  Serial.printf("%s boot (reset reason %d)\n", _warm_boot ? "Warm" : "Cold", (int)reason);
+  return _warm_boot;
+}
+
+bool is_warm_boot()
+{
+  return _warm_boot;
+}
+
+t_boot_state *get_boot_state()
+{
+  return &_boot_state;
+}
+
+void save_boot_state()
+{
+  _boot_state.crc = boot_state_crc();
+}
@@ -1,112 +1,330 @@
 #include "clock_config.h"
+#include <stddef.h>
+
+// Record layout version, bump when t_config_record changes
+#define CONFIG_VERSION 1
+// Commit once no change happened for this long...
+#define CONFIG_COMMIT_DELAY 2000
+// ...but never keep changes in RAM longer than this
+#define CONFIG_MAX_COMMIT_DELAY 10000
+
+// Whole configuration, stored as a single NVS blob
+typedef struct config_record
+{
+  uint16_t version;
+  uint16_t size;
+  uint32_t write_count;
+  int32_t clock_mode;
+  int32_t wireless_mode;
+  int32_t clock_timezone;
+  char ssid[64];
+  char password[64];
+  uint64_t sleep_time[3];   // 168 bits, bit (day * 24 + hour)
+  char timezone_rule[48];   // POSIX TZ string or zone name, empty for fixed offset
+  uint32_t driver_idle_timeout;   // seconds, 0 = drivers stay energized
+  uint32_t power_budget;          // mA, 0 = no limit
+  uint32_t crc;
+} t_config_record;
+
+#define SLEEP_SLOTS (7 * 24)
 
 // Non volatile preferences
 Preferences prefs;
 
 // Internal config state
-int _clock_mode;
-bool _sleep_time[7 * 24];
-int _clock_timezone;
+t_config_record _config;
+bool _config_dirty = false;
+uint32_t _config_first_change = 0;
+uint32_t _config_last_change = 0;
+
+static uint32_t crc32(const uint8_t *data, size_t length)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  while (length--)
+  {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++)
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+static uint32_t record_crc(const t_config_record &record)
+{
+  return crc32((const uint8_t *)&record, offsetof(t_config_record, crc));
+}
+
+static bool get_sleep_slot(int slot)
+{
+  return (_config.sleep_time[slot / 64] >> (slot % 64)) & 1;
+}
+
+static void set_sleep_slot(int slot, bool value)
+{
+  if (value)
+    _config.sleep_time[slot / 64] |= (uint64_t)1 << (slot % 64);
+  else
+    _config.sleep_time[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+}
+
+static void load_sleep_bools(const bool *sleep_time)
+{
+  for (int i = 0; i < SLEEP_SLOTS; i++)
+    set_sleep_slot(i, sleep_time[i]);
+}
+
+static void set_defaults()
+{
+  uint32_t write_count = _config.write_count;
+  memset(&_config, 0, sizeof(_config));
+  _config.version = CONFIG_VERSION;
+  _config.size = sizeof(_config);
+  _config.write_count = write_count;
+  _config.clock_mode = LAZY;
+  _config.wireless_mode = HOTSPOT;
+  _config.clock_timezone = 0;
+  _config.driver_idle_timeout = DEFAULT_DRIVER_IDLE_TIMEOUT;
+  _config.power_budget = DEFAULT_POWER_BUDGET;
+}
+
+static void mark_dirty()
+{
+  uint32_t now = millis();
+  if (!_config_dirty)
+    _config_first_change = now;
+  _config_last_change = now;
+  _config_dirty = true;
+}
 
-int _wireless_mode;
-char _ssid[64];
-char _password[64];
+// Reads the per-key layout used by older firmware
+static void load_legacy_config()
+{
+  _config.clock_mode = prefs.getInt("clock_mode", LAZY);
+  _config.wireless_mode = prefs.getInt("wireless_mode", HOTSPOT);
+  _config.clock_timezone = prefs.getInt("clock_timezone", 0);
+  strncpy(_config.ssid, prefs.getString("ssid", "").c_str(), sizeof(_config.ssid) - 1);
+  strncpy(_config.password, prefs.getString("password", "").c_str(), sizeof(_config.password) - 1);
+  if (prefs.isKey("sleep_time"))
+  {
+    bool sleep_time[SLEEP_SLOTS];
+    prefs.getBytes("sleep_time", sleep_time, sizeof(sleep_time));
+    load_sleep_bools(sleep_time);
+  }
+}
 
 void begin_config()
 {
   prefs.begin("clockclock24");
-  _clock_mode = prefs.getInt("clock_mode", LAZY);
-  _wireless_mode = prefs.getInt("wireless_mode", HOTSPOT);
-  _clock_timezone = prefs.getInt("clock_timezone", 0);
-  strncpy(_ssid, prefs.getString("ssid", "").c_str(), sizeof(_ssid));
-  strncpy(_password, prefs.getString("password", "").c_str(), sizeof(_password));
-  if(prefs.isKey("sleep_time"))
-    prefs.getBytes("sleep_time", _sleep_time, sizeof(_sleep_time));
-  else
-    memset(_sleep_time, 0, sizeof(_sleep_time));
+  memset(&_config, 0, sizeof(_config));
+  if (prefs.getBytesLength("config") == sizeof(_config))
+  {
+    prefs.getBytes("config", &_config, sizeof(_config));
+    if (_config.version == CONFIG_VERSION && _config.size == sizeof(_config) &&
+        _config.crc == record_crc(_config))
+      return;
+    Serial.println("Stored configuration is invalid, using defaults");
+  }
+  set_defaults();
+  if (prefs.isKey("clock_mode") || prefs.isKey("wireless_mode"))
+  {
+    Serial.println("Migrating configuration to a single record");
+    load_legacy_config();
+    mark_dirty();
+  }
 }
 
 void end_config()
 {
+  commit_config();
   prefs.end();
 }
 
 void clear_config()
 {
   prefs.clear();
-  _clock_mode = LAZY;
-  _wireless_mode = HOTSPOT;
-  strncpy(_ssid, "", sizeof(_ssid));
-  strncpy(_password, "", sizeof(_password));
-  memset(_sleep_time, 0, sizeof(_sleep_time));
+  set_defaults();
+  _config_dirty = false;
+}
+
+void commit_config()
+{
+  if (!_config_dirty)
+    return;
+  _config.write_count++;
+  _config.crc = record_crc(_config);
+  prefs.putBytes("config", &_config, sizeof(_config));
+  if (prefs.isKey("clock_mode"))
+  {
+    // First record written, the legacy keys are no longer needed
+    const char *legacy_keys[] = {"clock_mode", "wireless_mode", "clock_timezone", "ssid", "password", "sleep_time"};
+    for (const char *key : legacy_keys)
+      prefs.remove(key);
+  }
+  _config_dirty = false;
+  Serial.printf("Configuration saved (%u writes)\n", _config.write_count);
+}
+
+void config_loop()
+{
+  if (!_config_dirty)
+    return;
+  uint32_t now = millis();
+  if (now - _config_last_change >= CONFIG_COMMIT_DELAY ||
+      now - _config_first_change >= CONFIG_MAX_COMMIT_DELAY)
+    commit_config();
+}
+
+bool is_config_dirty()
+{
+  return _config_dirty;
+}
+
+uint32_t get_config_write_count()
+{
+  return _config.write_count;
 }
 
 int get_clock_mode()
 {
-  return _clock_mode;
+  return _config.clock_mode;
 }
 
 bool get_sleep_time(int day, int hour)
 {
-  return _sleep_time[(day * 24) + (hour % 24)];
+  return get_sleep_slot((day * 24) + (hour % 24));
+}
+
+int get_next_sleep_transition(int day, int minute)
+{
+  int slot = (day % 7) * 24 + (minute / 60) % 24;
+  bool state = get_sleep_slot(slot);
+  // Scan at most the 3 words after the current slot plus the wrap around
+  int next = slot + 1;
+  for (int i = 0; i < 4; i++)
+  {
+    int word = (next / 64) % 3;
+    uint64_t bits = state ? ~_config.sleep_time[word] : _config.sleep_time[word];
+    if (word == 2)
+      bits &= ((uint64_t)1 << (SLEEP_SLOTS - 128)) - 1;
+    bits &= ~(uint64_t)0 << (next % 64);
+    if (bits)
+    {
+      int found = word * 64 + __builtin_ctzll(bits);
+      int slots = (found - slot + SLEEP_SLOTS) % SLEEP_SLOTS;
+      if (slots == 0)
+        slots = SLEEP_SLOTS;
+      return slots * 60 - minute % 60;
+    }
+    next = ((word + 1) % 3) * 64;
+  }
+  return -1;
 }
 
 int get_connection_mode()
 {
-  return _wireless_mode;
+  return _config.wireless_mode;
 }
 
 int get_timezone()
 {
-  return _clock_timezone;
+  return _config.clock_timezone;
+}
+
+const char *get_timezone_rule()
+{
+  return _config.timezone_rule;
+}
+
+uint32_t get_driver_idle_timeout()
+{
+  return _config.driver_idle_timeout;
+}
+
+uint32_t get_power_budget()
+{
+  return _config.power_budget;
 }
 
 char *get_ssid()
 {
-  return _ssid;
+  return _config.ssid;
 }
 
 char *get_password()
 {
-  return _password;
+  return _config.password;
 }
 
-void set_clock_mode(int value)
+void set_driver_idle_timeout(uint32_t value)
 {
-  _clock_mode = value;
-  prefs.putInt("clock_mode", value);
+  if (_config.driver_idle_timeout == value)
+    return;
+  _config.driver_idle_timeout = value;
+  mark_dirty();
 }
 
-void set_sleep_time(int day, int hour, bool value)
+void set_power_budget(uint32_t value)
+{
+  if (_config.power_budget == value)
+    return;
+  _config.power_budget = value;
+  mark_dirty();
+}
+
+void set_clock_mode(int value)
 {
-  _sleep_time[(day * 24) + (hour % 24)] = value;
+  if (_config.clock_mode == value)
+    return;
+  _config.clock_mode = value;
+  mark_dirty();
 }
 
-void save_sleep_time()
+void set_sleep_time(int day, int hour, bool value)
 {
-  prefs.putBytes("sleep_time", _sleep_time, sizeof(_sleep_time));
+  int slot = (day * 24) + (hour % 24);
+  if (get_sleep_slot(slot) == value)
+    return;
+  set_sleep_slot(slot, value);
+  mark_dirty();
 }
 
 void set_connection_mode(int value)
 {
-  _wireless_mode = value;
-  prefs.putInt("wireless_mode", value);
+  if (_config.wireless_mode == value)
+    return;
+  _config.wireless_mode = value;
+  mark_dirty();
 }
 
 void set_timezone(int value)
 {
-  _clock_timezone = value;
-  prefs.putInt("clock_timezone", value);
+  if (_config.clock_timezone == value)
+    return;
+  _config.clock_timezone = value;
+  mark_dirty();
+}
+
+void set_timezone_rule(const char *value)
+{
+  if (strncmp(_config.timezone_rule, value, sizeof(_config.timezone_rule) - 1) == 0)
+    return;
+  memset(_config.timezone_rule, 0, sizeof(_config.timezone_rule));
+  strncpy(_config.timezone_rule, value, sizeof(_config.timezone_rule) - 1);
+  mark_dirty();
 }
 
 void set_ssid(const char *value)
 {
-  strncpy(_ssid, value, sizeof(_ssid));
-  prefs.putString("ssid", value);
+  if (strncmp(_config.ssid, value, sizeof(_config.ssid) - 1) == 0)
+    return;
+  strncpy(_config.ssid, value, sizeof(_config.ssid) - 1);
+  mark_dirty();
 }
 
 void set_password(const char *value)
 {
-  strncpy(_password, value, sizeof(_password));
-  prefs.putString("password", value);
-}
\ No newline at end of file
+  if (strncmp(_config.password, value, sizeof(_config.password) - 1) == 0)
+    return;
+  strncpy(_config.password, value, sizeof(_config.password) - 1);
+  mark_dirty();
+}
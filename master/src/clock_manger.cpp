@@ -1,15 +1,47 @@
 #include "clock_manager.h"
+#include "boot_state.h"
+#include "direction_planner.h"
+#include "power_model.h"
+
+// I2C command definitions (must match slave)
+#define CMD_DRIVERS_DISABLE 0x00
+#define CMD_DRIVERS_ENABLE  0x01
+#define CMD_HOME            0x02
+#define CMD_IDLE_TIMEOUT    0x03  // followed by uint16_t seconds
+// General call, followed by uint32_t bus time (µs). 0x00, 0x04 and 0x06 are
+// reserved by the I2C spec and odd bytes are hardware general calls, other
+// devices ignore the remaining even bytes
+#define CMD_SYNC            0x10
+
+// Power budget: a board start is pushed back at most this long (ms), then its acceleration is halved, up to POWER_ACCEL_HALVINGS times
+#define POWER_MAX_DELAY 4000
+#define POWER_ACCEL_HALVINGS 2
+// Staggered poses are uploaded as timed frames: 8 frames at 100 kHz and a margin (ms)
+#define POWER_UPLOAD_LEAD 80
 
 int _speed = 200;
 int _acceleration = 100;
 int _direction = MIN_DISTANCE;
+int _direction_style = STYLE_FIXED;
 
 // Changes when the clock state changes
 uint32_t _counter = 1;
 
-const t_digit _digits[10] = {digit_0, digit_1, digit_2, digit_3, digit_4, digit_5, digit_6, digit_7, digit_8, digit_9};
+constexpr t_digit _digits[10] = {digit_0, digit_1, digit_2, digit_3, digit_4, digit_5, digit_6, digit_7, digit_8, digit_9};
 // Last sended clock state
 half_digit _last_state[8] = {0};
+// Slowest hand of the last transition (ms)
+uint32_t _last_transition_ms = 0;
+// Boards whose last frame was not acknowledged, resent even if unchanged
+uint8_t _send_failed = 0;
+// Frames written to the bus and frames skipped because no hand would move
+uint32_t _frames_sent = 0;
+uint32_t _frames_skipped = 0;
+// Modeled last move of each hand (h0, m0, h1... board by board), see power_model.h
+t_power_move _power_moves[POWER_HANDS] = {0};
+// Highest modeled load since reset_peak_load(), and per clock mode (mA)
+uint32_t _peak_load = 0;
+uint32_t _mode_peak_load[OFF] = {0};
 
 int get_speed()
 {
@@ -31,6 +63,16 @@ void set_acceleration(int value)
   _acceleration = value;
 }
 
+int get_direction_style()
+{
+  return _direction_style;
+}
+
+void set_direction_style(int value)
+{
+  _direction_style = value;
+}
+
 int get_direction()
 {
   return _direction;
@@ -42,31 +84,370 @@ void set_direction(int value)
 }
 
 
-void send_half_digit(int index, t_half_digit half_digit)
+int get_hand_travel(int from, int to, int mode)
+{
+  int cw = (to - from) % 360;
+  cw = (cw <= 0) ? -cw : 360 - cw;
+  int ccw = (to - from) % 360;
+  ccw = (ccw < 0) ? 360 + ccw : ccw;
+
+  if (mode <= CLOCKWISE3)
+    return cw + 360 * mode;
+  if (mode <= COUNTERCLOCKWISE3)
+    return ccw + 360 * (mode - COUNTERCLOCKWISE);
+  if (mode <= MIN_DISTANCE3)
+    return min(cw, ccw) + 360 * (mode - MIN_DISTANCE);
+  if (mode <= MAX_DISTANCE3)
+    return max(cw, ccw) + 360 * (mode - MAX_DISTANCE);
+  return 0;
+}
+
+uint32_t estimate_move_ms(int degrees, int speed, int accel)
+{
+  if (degrees <= 0 || speed <= 0 || accel <= 0)
+    return 0;
+  float steps = (float)degrees * MOTOR_STEPS / 360;
+  // Distance needed to reach max speed and brake again
+  float ramp_steps = (float)speed * speed / accel;
+  if (steps >= ramp_steps)
+    return (uint32_t)(1000.0f * (steps / speed + (float)speed / accel));
+  return (uint32_t)(2000.0f * sqrtf(steps / accel));
+}
+
+uint32_t get_last_transition_ms()
+{
+  return _last_transition_ms;
+}
+
+void reset_peak_load()
+{
+  _peak_load = 0;
+}
+
+uint32_t get_peak_load()
+{
+  return _peak_load;
+}
+
+void save_peak_load(int mode)
+{
+  if (mode >= 0 && mode < OFF)
+    _mode_peak_load[mode] = _peak_load;
+}
+
+uint32_t get_mode_peak_load(int mode)
+{
+  return mode >= 0 && mode < OFF ? _mode_peak_load[mode] : 0;
+}
+
+// Slowest hand moving from _last_state[index] to half_digit
+static uint32_t estimate_half_digit_ms(int index, const t_half_digit &half_digit)
+{
+  uint32_t duration = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    if (half_digit.clocks[i].mode_h > MAX_DISTANCE3)
+      continue;
+    duration = max(duration, estimate_clock_ms(_last_state[index].clocks[i], half_digit.clocks[i]));
+  }
+  return duration;
+}
+
+// Keeps track of the pose sent to a board, also across resets
+static void store_last_state(int index, const t_half_digit &half_digit)
+{
+  _last_state[index] = half_digit;
+  t_boot_state *boot = get_boot_state();
+  for (int i = 0; i < 3; i++)
+  {
+    boot->pose[index].clocks[i].angle_h = half_digit.clocks[i].angle_h;
+    boot->pose[index].clocks[i].angle_m = half_digit.clocks[i].angle_m;
+  }
+  boot->counter = _counter;
+  save_boot_state();
+}
+
+static bool is_rotating(const t_clock &clock)
+{
+  return clock.mode_h >= ROTATE_CLOCKWISE || clock.mode_m >= ROTATE_CLOCKWISE;
+}
+
+// Clocks of half_digit that would move from _last_state[index]
+static uint8_t get_moving_clocks(int index, const t_half_digit &half_digit)
+{
+  uint8_t moving = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    const t_clock &from = _last_state[index].clocks[i];
+    const t_clock &to = half_digit.clocks[i];
+    // Same rotation again: keeps turning, the board leaves it alone
+    if (is_rotating(to) && memcmp(&from, &to, sizeof(t_clock)) == 0)
+      continue;
+    // Extra turns move even to the same angle, adjustments always move, rotations end with a frame
+    if (to.mode_h > MAX_DISTANCE3 || to.mode_m > MAX_DISTANCE3 || is_rotating(from) ||
+        get_hand_travel(from.angle_h, to.angle_h, to.mode_h) != 0 ||
+        get_hand_travel(from.angle_m, to.angle_m, to.mode_m) != 0)
+      moving |= 1 << i;
+  }
+  return moving;
+}
+
+// Plans the directions of the masked clocks of consecutive boards, together
+static void plan_frames(int first, int count, t_half_digit *frames, uint8_t clocks)
+{
+  t_clock from[24];
+  t_clock to[24];
+  int n = 0;
+  for (int b = 0; b < count; b++)
+    for (int i = 0; i < 3; i++)
+      if (clocks & (1 << i))
+      {
+        from[n] = _last_state[first + b].clocks[i];
+        to[n++] = frames[b].clocks[i];
+      }
+  plan_directions(from, to, n, _direction_style);
+  n = 0;
+  for (int b = 0; b < count; b++)
+    for (int i = 0; i < 3; i++)
+      if (clocks & (1 << i))
+        frames[b].clocks[i] = to[n++];
+}
+
+// Writes a frame, t_half_digit or t_timed_half_digit, the board tells them apart by size
+template <typename T> static void write_frame(int index, const T &frame)
 {
   Wire.beginTransmission(index + 1);
-  I2C_writeAnything(half_digit);
-  Wire.endTransmission();
+  I2C_writeAnything(frame);
+  if (Wire.endTransmission() == 0)
+    _send_failed &= ~(1 << index);
+  else
+    _send_failed |= 1 << index;
+  _frames_sent++;
+}
+
+static void write_half_digit(int index, const t_half_digit &half_digit)
+{
+  write_frame(index, half_digit);
+}
+
+// Keeps the counters of the clocks that don't move, false if nothing has to be sent
+static bool prepare_half_digit(int index, t_half_digit &half_digit)
+{
+  uint8_t moving = get_moving_clocks(index, half_digit);
+  if (moving == 0 && !(_send_failed & (1 << index)))
+  {
+    _frames_skipped++;
+    return false;
+  }
+  // Clocks that don't move keep their counter, the board leaves them alone
+  for (int i = 0; i < 3; i++)
+    if (!(moving & (1 << i)) && !(_send_failed & (1 << index)))
+      half_digit.change_counter[i] = _last_state[index].change_counter[i];
+  _last_transition_ms = max(_last_transition_ms, estimate_half_digit_ms(index, half_digit));
+  return true;
+}
+
+static void send_frame(int index, t_half_digit half_digit)
+{
+  if (!prepare_half_digit(index, half_digit))
+    return;
+  write_half_digit(index, half_digit);
+  store_last_state(index, half_digit);
+}
+
+static void send_timed_frame(int index, t_half_digit half_digit, uint32_t start_us)
+{
+  t_timed_half_digit frame = {half_digit, start_us};
+  if (!prepare_half_digit(index, frame.half_digit))
+    return;
+  write_frame(index, frame);
+  // The pose the board will reach, the next frames are planned from it
+  store_last_state(index, frame.half_digit);
+}
+
+// Models the hands of the moving clocks of a frame as if they started at 0,
+// the profile of the board is then shifted to its start
+static void get_board_moves(int index, const t_half_digit &half_digit, uint8_t moving, t_power_move *planned)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    if (!(moving & (1 << i)))
+      continue;
+    const t_clock &from = _last_state[index].clocks[i];
+    const t_clock &to = half_digit.clocks[i];
+    t_power_move &h = planned[i*2];
+    t_power_move &m = planned[i*2 + 1];
+    // Rotations run until the next frame
+    if (to.mode_h >= ROTATE_CLOCKWISE)
+    {
+      h = plan_power_move(360, to.speed_h, to.accel_h, 0, 0);
+      m = plan_power_move(360, to.speed_m, to.accel_m, 0, 0);
+      h.duration = m.duration = INT32_MAX;
+      continue;
+    }
+    int travel_h = get_hand_travel(from.angle_h, to.angle_h, to.mode_h);
+    int travel_m = get_hand_travel(from.angle_m, to.angle_m, to.mode_m);
+    uint32_t arrive = 0;
+    if (POWER_COORDINATED_DIALS)
+      arrive = max(estimate_move_ms(travel_h, to.speed_h, to.accel_h), estimate_move_ms(travel_m, to.speed_m, to.accel_m));
+    h = plan_power_move(travel_h, to.speed_h, to.accel_h, 0, arrive);
+    m = plan_power_move(travel_m, to.speed_m, to.accel_m, 0, arrive);
+  }
+}
+
+// Puts the planned moves of a board at start, other hands keep their move
+static void place_board_moves(t_power_move *moves, int index, uint8_t moving, const t_power_move *planned, uint32_t start)
+{
+  for (int i = 0; i < 6; i++)
+    if (moving & (1 << (i / 2)))
+    {
+      moves[index*6 + i] = planned[i];
+      moves[index*6 + i].start = start;
+    }
+}
+
+// Longest planned move of a board, bounded for the windows of the peak search
+static uint32_t get_board_duration(uint8_t moving, const t_power_move *planned)
+{
+  uint32_t duration = 0;
+  for (int i = 0; i < 6; i++)
+    if (moving & (1 << (i / 2)))
+      duration = max(duration, planned[i].duration);
+  return min(duration, (uint32_t)POWER_MAX_DELAY * 4);
+}
+
+// First start that keeps the load under the budget: now, or when a move of
+// another board stops ramping or ends; the acceleration of the frame is
+// halved when none fits. The profile of the board is planned once per
+// acceleration and only shifted to each start.
+static uint32_t find_power_slot(int index, t_half_digit &half_digit, uint8_t moving, uint32_t now, uint32_t budget, t_power_move *planned)
+{
+  t_power_move trial[POWER_HANDS];
+  memcpy(trial, _power_moves, sizeof(trial));
+  for (int halving = 0; ; halving++)
+  {
+    get_board_moves(index, half_digit, moving, planned);
+    uint32_t duration = get_board_duration(moving, planned);
+    uint32_t fit = UINT32_MAX;
+    uint32_t best = 0;
+    uint32_t best_peak = UINT32_MAX;
+    for (int i = -1; i < POWER_HANDS * 2; i++)
+    {
+      uint32_t offset = 0;
+      if (i >= 0)
+      {
+        // The hands of the board itself get the new moves
+        if (i / 12 == index)
+          continue;
+        const t_power_move &move = _power_moves[i / 2];
+        if (move.duration == 0)
+          continue;
+        offset = (i % 2 ? move.start + move.duration : move.start + move.ramp) - now;
+        if ((int32_t)offset <= 0 || offset > POWER_MAX_DELAY)
+          continue;
+      }
+      place_board_moves(trial, index, moving, planned, now + offset);
+      uint32_t peak = power_peak_between(trial, POWER_HANDS, now + offset, now + offset + duration);
+      if (peak <= budget)
+        fit = min(fit, offset);
+      if (peak < best_peak)
+      {
+        best_peak = peak;
+        best = offset;
+      }
+    }
+    if (fit != UINT32_MAX)
+      return fit;
+    if (halving == POWER_ACCEL_HALVINGS)
+      return best;
+    for (int i = 0; i < 3; i++)
+      if (moving & (1 << i))
+      {
+        half_digit.clocks[i].accel_h = max(1, half_digit.clocks[i].accel_h / 2);
+        half_digit.clocks[i].accel_m = max(1, half_digit.clocks[i].accel_m / 2);
+      }
+  }
+}
+
+// Staggers the boards of a pose to keep the modeled load under the power
+// budget, or only records the modeled moves
+// @return true if some board has to start later than the others
+static bool schedule_power(int first, int count, t_half_digit *frames, uint32_t now, uint32_t *offsets, bool stagger)
+{
+  uint32_t budget = get_power_budget();
+  bool staggered = false;
+  uint32_t end = now;
+  for (int b = 0; b < count; b++)
+  {
+    offsets[b] = 0;
+    uint8_t moving = get_moving_clocks(first + b, frames[b]);
+    if (moving == 0)
+      continue;
+    t_power_move planned[6];
+    if (stagger && budget > 0)
+      offsets[b] = find_power_slot(first + b, frames[b], moving, now, budget, planned);
+    else
+      get_board_moves(first + b, frames[b], moving, planned);
+    staggered |= offsets[b] > 0;
+    place_board_moves(_power_moves, first + b, moving, planned, now + offsets[b]);
+    end = max(end, now + offsets[b] + get_board_duration(moving, planned));
+  }
+  _peak_load = max(_peak_load, power_peak_between(_power_moves, POWER_HANDS, now, end));
+  return staggered;
+}
+
+// Frames of consecutive boards planned as one pose
+static void send_frames(int first, int count, t_half_digit *frames)
+{
+  plan_frames(first, count, frames, 0x07);
+  uint32_t offsets[8];
+  if (!schedule_power(first, count, frames, millis(), offsets, true))
+  {
+    for (int i = 0; i < count; i++)
+      send_frame(first + i, frames[i]);
+    return;
+  }
+  // Late boards are held by the boards themselves, see send_sync_beacon()
+  uint32_t transition = _last_transition_ms;
+  send_sync_beacon();
+  uint32_t start = get_bus_time() + POWER_UPLOAD_LEAD * 1000;
+  for (int i = 0; i < count; i++)
+  {
+    _last_transition_ms = 0;
+    send_timed_frame(first + i, frames[i], start + offsets[i] * 1000);
+    if (_last_transition_ms > 0)
+      transition = max(transition, POWER_UPLOAD_LEAD + offsets[i] + _last_transition_ms);
+  }
+  _last_transition_ms = transition;
+}
+
+void send_half_digit(int index, t_half_digit half_digit)
+{
+  send_frames(index, 1, &half_digit);
 }
 
 // 0 <= index < 4
-void send_digit(int index, t_digit digit)
+void send_digit(int index, const t_digit &digit)
+{
+  t_half_digit frames[2] = {get_full_half_digit(digit.halfs[0]), get_full_half_digit(digit.halfs[1])};
+  send_frames(index*2, 2, frames);
+}
+
+// Poses only get the wire format here, one frame per column
+static void send_pose(const t_pose &pose)
 {
-    t_half_digit l = get_full_half_digit(digit.halfs[0]);
-    t_half_digit r = get_full_half_digit(digit.halfs[1]);
-    send_half_digit(index*2, l);
-    send_half_digit(index*2 + 1, r);
-    _last_state[index*2] = l;
-    _last_state[index*2 + 1] = r;
+  t_half_digit frames[POSE_COLUMNS];
+  for (int i = 0; i < POSE_COLUMNS; i++)
+    frames[i] = get_full_half_digit(pose_column(pose, i));
+  send_frames(0, POSE_COLUMNS, frames);
 }
 
-void send_clock(t_full_clock full_clock)
+void send_clock(const t_full_clock &full_clock)
 {
-  for (int i = 0; i < 4; i++)
-    send_digit(i, full_clock.digit[i]);
+  send_pose(pose_from_clock(full_clock));
 }
 
-t_half_digit get_full_half_digit(t_half_digitl lite_digit)
+t_half_digit get_full_half_digit(const t_half_digitl &lite_digit)
 {
     t_half_digit tmp = {0};
     for (int i = 0; i < 3; i++)
@@ -86,33 +467,128 @@ t_half_digit get_full_half_digit(t_half_digitl lite_digit)
   return tmp;
 }
 
-void set_clock(t_full_clock clock_state)
+void set_clock(const t_full_clock &clock_state)
 {
+  _last_transition_ms = 0;
   send_clock(clock_state);
   _counter++;
 }
 
+void set_pose(const t_pose &pose)
+{
+  _last_transition_ms = 0;
+  send_pose(pose);
+  _counter++;
+}
+
 // 0 <= index < 4
-void set_digit(int index, t_digit digit)
+void set_digit(int index, const t_digit &digit)
 {
+  _last_transition_ms = 0;
   send_digit(index, digit);
   _counter++;
 }
 
 // 0 <= index < 8
-void set_half_digit(int index, t_half_digitl half)
+void set_half_digit(int index, const t_half_digitl &half)
 {
-    t_half_digit hd = get_full_half_digit(half);
-    send_half_digit(index, hd);
-    _last_state[index] = hd;
+    _last_transition_ms = 0;
+    send_half_digit(index, get_full_half_digit(half));
     _counter++;
 }
 
+void plan_pose_frames(const t_full_clock &target, t_half_digit frames[8])
+{
+  for (int i = 0; i < 8; i++)
+    frames[i] = get_full_half_digit(get_column(target, i));
+  plan_frames(0, 8, frames, 0x07);
+}
+
+// Planned frame with only the masked clocks changed from the last state sent
+static t_half_digit get_masked_half_digit(int index, const t_half_digit &planned, uint8_t clocks)
+{
+  t_half_digit full = planned;
+  for (int i = 0; i < 3; i++)
+  {
+    if (clocks & (1 << i))
+    {
+      // Planned before the earlier parts were sent
+      full.change_counter[i] = _counter;
+      continue;
+    }
+    // Same angles without extra turns: not moving, the board leaves it alone
+    full.clocks[i] = _last_state[index].clocks[i];
+    if (is_rotating(full.clocks[i]))
+      continue;
+    full.clocks[i].mode_h = MIN_DISTANCE;
+    full.clocks[i].mode_m = MIN_DISTANCE;
+  }
+  return full;
+}
+
+void set_half_digit_clocks(int index, const t_half_digit &planned, uint8_t clocks)
+{
+  _last_transition_ms = 0;
+  t_half_digit frame = get_masked_half_digit(index, planned, clocks);
+  // Already a staggered step, only recorded
+  uint32_t offset;
+  schedule_power(index, 1, &frame, millis(), &offset, false);
+  send_frame(index, frame);
+  _counter++;
+}
+
+void set_half_digit_clocks_at(int index, const t_half_digit &planned, uint8_t clocks, uint32_t start_us)
+{
+  _last_transition_ms = 0;
+  t_half_digit frame = get_masked_half_digit(index, planned, clocks);
+  uint32_t offset;
+  schedule_power(index, 1, &frame, millis() + (int32_t)(start_us - get_bus_time()) / 1000, &offset, false);
+  send_timed_frame(index, frame, start_us);
+  _counter++;
+}
+
+uint32_t get_bus_time()
+{
+  return micros();
+}
+
+void send_sync_beacon()
+{
+  Wire.beginTransmission(0);
+  Wire.write(CMD_SYNC);
+  // Stamped last, the transfer starts in endTransmission()
+  uint32_t bus_us = get_bus_time() + BUS_SYNC_LATENCY;
+  I2C_writeAnything(bus_us);
+  Wire.endTransmission();
+}
+
+void set_field(t_field field, uint32_t t)
+{
+  t_pose pose;
+  for (int col = 0; col < FIELD_COLUMNS; col++)
+    for (int row = 0; row < FIELD_ROWS; row++)
+      pose_set_clock(pose, col, row, field(col, row, t));
+  set_pose(pose);
+}
+
 void set_clock_time(int h, int m)
 {
   if(h < 0 || h > 99 || m < 0 || m > 99 )
     return;
-  set_clock(get_clock_state_from_time(h, m));
+  Serial.printf("Set time: %d:%d\n", h, m);
+  // Straight from the flash tables, no full clock copy
+  _last_transition_ms = 0;
+  const t_digit *digits[4] = {&_digits[h / 10], &_digits[h % 10], &_digits[m / 10], &_digits[m % 10]};
+  t_half_digit frames[8];
+  for (int i = 0; i < 8; i++)
+    frames[i] = get_full_half_digit(digits[i / 2]->halfs[i % 2]);
+  send_frames(0, 8, frames);
+  _counter++;
+}
+
+const t_digit &get_digit(int value)
+{
+  return _digits[value];
 }
 
 t_full_clock get_clock_state_from_time(int h, int m)
@@ -138,24 +614,126 @@ void adjust_hands(int clock_index, int h_amount, int m_amount)
   tmp.clocks[clock_index % 3].accel_h = 5000;
   tmp.clocks[clock_index % 3].accel_m = 5000;
   tmp.change_counter[clock_index % 3] = _counter;
-  send_half_digit(clock_index/3, tmp);
+  // Not a pose, _last_state keeps the target angles
+  write_half_digit(clock_index/3, tmp);
   _counter++;
 }
 
-// I2C command definitions (must match slave)
-#define CMD_DRIVERS_DISABLE 0x00
-#define CMD_DRIVERS_ENABLE  0x01
+void get_send_stats(uint32_t &sent, uint32_t &skipped)
+{
+  sent = _frames_sent;
+  skipped = _frames_skipped;
+}
+
+t_half_digit get_last_half_digit(int index)
+{
+  return _last_state[index];
+}
+
+t_pose get_last_pose()
+{
+  t_pose pose;
+  for (int col = 0; col < POSE_COLUMNS; col++)
+    for (int row = 0; row < POSE_ROWS; row++)
+    {
+      pose.angle[pose_index(col, row, HAND_H)] = _last_state[col].clocks[row].angle_h;
+      pose.angle[pose_index(col, row, HAND_M)] = _last_state[col].clocks[row].angle_m;
+    }
+  return pose;
+}
+
+bool read_board_status(int index, t_board_status &status)
+{
+  if (Wire.requestFrom(index + 1, (int)sizeof(status)) != sizeof(status))
+    return false;
+  I2C_readAnything(status);
+  return status.version == BOARD_STATUS_VERSION;
+}
+
+int sync_clock_state()
+{
+  // Boards assume their hands at 270 (INIT_HANDS_ANGLE) after a power on
+  for (int i = 0; i < 8; i++)
+    for (int j = 0; j < 3; j++)
+    {
+      _last_state[i].clocks[j].angle_h = 270;
+      _last_state[i].clocks[j].angle_m = 270;
+    }
+
+  if (is_warm_boot())
+  {
+    t_boot_state *boot = get_boot_state();
+    for (int i = 0; i < 8; i++)
+      for (int j = 0; j < 3; j++)
+      {
+        _last_state[i].clocks[j].angle_h = boot->pose[i].clocks[j].angle_h;
+        _last_state[i].clocks[j].angle_m = boot->pose[i].clocks[j].angle_m;
+      }
+    _counter = boot->counter + 1;
+  }
+
+  // Boards know better, they may have been running while the master rebooted
+  int found = 0;
+  for (int i = 0; i < 8; i++)
+  {
+    t_board_status status;
+    if (!read_board_status(i, status))
+      continue;
+    found++;
+    if (status.flags & STATUS_POSITION_UNCERTAIN)
+      Serial.printf("Board %d: hands 0x%02x lost their position during a power cut\n",
+        i + 1, status.uncertain);
+    for (int j = 0; j < 3; j++)
+    {
+      _last_state[i].clocks[j].angle_h = status.angle[j*2];
+      _last_state[i].clocks[j].angle_m = status.angle[j*2 + 1];
+      _last_state[i].change_counter[j] = status.change_counter[j];
+      // A new command must never reuse the counter a board applied last
+      if (status.change_counter[j] >= _counter)
+        _counter = status.change_counter[j] + 1;
+    }
+  }
+  Serial.printf("Hands position: %d boards answered, %s pose\n",
+    found, is_warm_boot() ? "retained" : "default");
+  return found;
+}
 
 void set_all_drivers_enabled(bool enabled)
 {
-  uint8_t cmd = enabled ? CMD_DRIVERS_ENABLE : CMD_DRIVERS_DISABLE;
   Serial.printf("Sending drivers %s command to all boards\n", enabled ? "enable" : "disable");
 
   // Send to all 8 slave boards (addresses 1-8)
+  for (int i = 0; i < 8; i++)
+    set_board_drivers_enabled(i, enabled);
+}
+
+void set_board_drivers_enabled(int index, bool enabled)
+{
+  Wire.beginTransmission(index + 1);
+  Wire.write(enabled ? CMD_DRIVERS_ENABLE : CMD_DRIVERS_DISABLE);
+  Wire.endTransmission();
+}
+
+void set_all_idle_timeout(uint16_t seconds)
+{
+  Serial.printf("Sending idle timeout %u s to all boards\n", seconds);
+  for (int i = 0; i < 8; i++)
+  {
+    Wire.beginTransmission(i + 1);
+    Wire.write(CMD_IDLE_TIMEOUT);
+    Wire.write(seconds & 0xFF);
+    Wire.write(seconds >> 8);
+    Wire.endTransmission();
+  }
+}
+
+void home_all_boards()
+{
+  Serial.println("Sending home command to all boards");
   for (int i = 0; i < 8; i++)
   {
     Wire.beginTransmission(i + 1);
-    Wire.write(cmd);
+    Wire.write(CMD_HOME);
     Wire.endTransmission();
   }
-}
\ No newline at end of file
+}
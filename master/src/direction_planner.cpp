@@ -0,0 +1,120 @@
+#include "direction_planner.h"
+#include "clock_manager.h"
+
+// CLOCKWISE, COUNTERCLOCKWISE, MIN_DISTANCE or MAX_DISTANCE, and the turns on top
+static int get_way(int mode)
+{
+  return mode - mode % 3;
+}
+
+static int get_turns(int mode)
+{
+  return mode % 3;
+}
+
+static bool is_planned(const t_clock &to)
+{
+  return to.mode_h <= MIN_DISTANCE3 && to.mode_m <= MIN_DISTANCE3;
+}
+
+uint32_t estimate_clock_ms(const t_clock &from, const t_clock &to)
+{
+  uint32_t h = estimate_move_ms(get_hand_travel(from.angle_h, to.angle_h, to.mode_h), to.speed_h, to.accel_h);
+  uint32_t m = estimate_move_ms(get_hand_travel(from.angle_m, to.angle_m, to.mode_m), to.speed_m, to.accel_m);
+  return max(h, m);
+}
+
+static int get_clock_travel(const t_clock &from, const t_clock &to)
+{
+  return get_hand_travel(from.angle_h, to.angle_h, to.mode_h) +
+         get_hand_travel(from.angle_m, to.angle_m, to.mode_m);
+}
+
+// Takes the hand assignment that arrives first, then the one with the
+// shortest total travel, returns the duration
+static uint32_t assign_hands(const t_clock &from, t_clock &to)
+{
+  uint32_t kept_ms = estimate_clock_ms(from, to);
+  if (to.angle_h == to.angle_m)
+    return kept_ms;
+  t_clock swapped = to;
+  swapped.angle_h = to.angle_m;
+  swapped.angle_m = to.angle_h;
+  uint32_t swapped_ms = estimate_clock_ms(from, swapped);
+  if (swapped_ms < kept_ms ||
+      (swapped_ms == kept_ms && get_clock_travel(from, swapped) < get_clock_travel(from, to)))
+  {
+    to = swapped;
+    return swapped_ms;
+  }
+  return kept_ms;
+}
+
+// Same way for both hands, the minimum turns of each hand kept
+static t_clock with_way(t_clock to, int way)
+{
+  to.mode_h = way + get_turns(to.mode_h);
+  to.mode_m = way + get_turns(to.mode_m);
+  return to;
+}
+
+// Longest way for a hand that still arrives within the pose duration
+static uint8_t fill_hand(int from, int to, uint8_t mode, int speed, int accel, uint32_t duration)
+{
+  int way = get_way(mode);
+  uint8_t best = mode;
+  uint32_t best_ms = estimate_move_ms(get_hand_travel(from, to, mode), speed, accel);
+  for (int turns = get_turns(mode); turns < 3; turns++)
+  {
+    for (int candidate_way = CLOCKWISE; candidate_way <= COUNTERCLOCKWISE; candidate_way += 3)
+    {
+      // MIN_DISTANCE may go either way, the others keep their way
+      if (way != MIN_DISTANCE && way != candidate_way)
+        continue;
+      uint8_t candidate = candidate_way + turns;
+      uint32_t ms = estimate_move_ms(get_hand_travel(from, to, candidate), speed, accel);
+      if (ms <= duration && ms > best_ms)
+      {
+        best = candidate;
+        best_ms = ms;
+      }
+    }
+  }
+  return best;
+}
+
+uint32_t plan_directions(const t_clock *from, t_clock *to, int count, int style)
+{
+  if (style == STYLE_ONE_WAY)
+  {
+    // Whole pose one way, the other way is tried on copies
+    uint32_t longest[2] = {0, 0};
+    const int ways[2] = {CLOCKWISE, COUNTERCLOCKWISE};
+    for (int w = 0; w < 2; w++)
+      for (int i = 0; i < count; i++)
+      {
+        if (!is_planned(to[i]))
+          continue;
+        t_clock planned = with_way(to[i], ways[w]);
+        longest[w] = max(longest[w], assign_hands(from[i], planned));
+      }
+    int way = longest[1] < longest[0] ? COUNTERCLOCKWISE : CLOCKWISE;
+    for (int i = 0; i < count; i++)
+      if (is_planned(to[i]))
+        to[i] = with_way(to[i], way);
+  }
+
+  uint32_t duration = 0;
+  for (int i = 0; i < count; i++)
+    duration = max(duration, is_planned(to[i]) ? assign_hands(from[i], to[i]) : estimate_clock_ms(from[i], to[i]));
+
+  if (style == STYLE_FILL)
+    for (int i = 0; i < count; i++)
+    {
+      if (!is_planned(to[i]))
+        continue;
+      to[i].mode_h = fill_hand(from[i].angle_h, to[i].angle_h, to[i].mode_h, to[i].speed_h, to[i].accel_h, duration);
+      to[i].mode_m = fill_hand(from[i].angle_m, to[i].angle_m, to[i].mode_m, to[i].speed_m, to[i].accel_m, duration);
+    }
+  return duration;
+}
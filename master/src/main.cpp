@@ -13,17 +13,135 @@
 #include "web_server.h"
 #include "clock_config.h"
 #include "ntp.h"
+#include "timezone.h"
+#include "boot_state.h"
+#include "udp_control.h"
+#include "wavefront.h"
+#include "direction_planner.h"
 
 
 int last_hour = -1;
 int last_minute = -1;
 bool is_stopped = false;
+bool was_streaming = false;
+// millis() of the next sleep schedule evaluation while the clock sleeps
+uint32_t next_sleep_check = 0;
+// Drivers re-enabled ahead of the wake-up transition
+bool drivers_prespun = false;
+// Minute boundary the idle-gated motors were last woken up for
+time_t drivers_woken_for = 0;
+// Next board to wake up, 8 when no wake up is running
+int wake_board = 8;
+uint32_t wake_board_ms = 0;
+
+// Drivers are re-enabled this long before a scheduled wake up (ms)
+#define DRIVER_WAKE_LEAD 3000
+// Motors de-energized by the idle timeout are woken up this long before an animation (ms)
+#define DRIVER_IDLE_WAKE_LEAD 500
+// Boards are woken up one after the other, this far apart, to spread the
+// current drawn by the motors getting energized (ms, 8 boards fit in DRIVER_IDLE_WAKE_LEAD)
+#define DRIVER_WAKE_STAGGER 60
+// Sleep schedule is evaluated at least this often while sleeping (ms)
+#define SLEEP_CHECK_INTERVAL 60000
+// Shortest frame interval of the field patterns (ms)
+#define FIELD_FRAME 200
+// WIND: time for a gust to cross one column (ms)
+#define WIND_PERIOD 5000
+// RAIN: time between two drops on the same column (ms)
+#define RAIN_PERIOD 3000
+// OBLIQUES: half turn of the lines (ms), and delay between two columns starting (ms)
+#define OBLIQUES_PERIOD 6000
+#define OBLIQUES_LAG 400
+// Bus time beacon interval, keeps the boards' clocks within a few µs (ms)
+#define SYNC_BEACON_INTERVAL 1000
+// Wavefronts: time to upload one timed frame (64 bytes at 100 kHz), and margin before the first start (ms)
+#define WAVE_UPLOAD_MS 7
+#define WAVE_UPLOAD_MARGIN 20
+// SPINNING: rotation speed (steps/sec) and how long the hands turn (ms)
+#define SPIN_SPEED 600
+#define SPIN_DURATION 10000
+// Longest lead allowed, an animation can't start before the previous minute is shown (ms)
+#define MAX_MODE_LEAD 55000
+
+// Predicted time from the start of an animation to the arrival of the
+// final time pose, per clock mode (ms). Seeded from the scripted delays,
+// then learned from each run: the animation time plus the estimated
+// duration of the last move (see get_last_transition_ms()).
+int32_t mode_lead_ms[OFF] = {
+  8000,   // LAZY
+  24000,  // FUN
+  37000,  // WAVES
+  20000,  // SPINNING
+  16500,  // SQUARES
+  21000,  // SYMMETRICAL
+  24000,  // WIND
+  15000,  // CASCADE
+  19500,  // FIREWORK
+  27000,  // OBLIQUES
+  21000,  // RIPPLE
+  22000,  // BREATHE
+  27000,  // RAIN
+  26500,  // HEARTBEAT
+  25000   // DANCE
+};
 
 /**
  * Sets clock to the current time
 */
 void set_time();
 
+/**
+ * Starts waking up the drivers of all boards, one board every
+ * DRIVER_WAKE_STAGGER ms, see wake_drivers_loop()
+*/
+void wake_drivers();
+
+/**
+ * Wakes up the next board when its turn comes, needs to be called on the main loop
+*/
+void wake_drivers_loop();
+
+/**
+ * Returns current local time with millisecond resolution
+ * @return milliseconds since 1970-01-01 in the local time zone
+*/
+int64_t local_now_ms();
+
+/**
+ * Logs the difference between the predicted arrival of the time pose
+ * and the minute boundary, then updates the mode lead. The last move is
+ * estimated from its profile, not measured on the boards
+ * @param mode        clock mode
+ * @param start       millis() when the animation started
+ * @param target_ms   local time of the minute boundary
+*/
+void log_arrival(int mode, uint32_t start, int64_t target_ms);
+
+/**
+ * Keeps and logs the highest modeled motor load of an animation
+ * @param mode    clock mode
+*/
+void log_peak_load(int mode);
+
+/**
+ * Runs the current mode animation to show the given time
+ * @param mode        clock mode
+ * @param h           hour
+ * @param m           minute
+ * @param target_ms   local time the time pose should arrive at
+*/
+void show_time(int mode, int h, int m, int64_t target_ms);
+
+/**
+ * Saves the current time in the retained state, at most once per second
+*/
+void save_boot_time();
+
+/**
+ * Sends the bus time to the boards, at most once per SYNC_BEACON_INTERVAL
+*/
+void sync_bus_time();
+
 /**
  * Sets clock time using lazy animation
 */
@@ -110,12 +228,34 @@ void stop();
 */
 void _delay(int value);
 
+/**
+ * Plays a field pattern, one frame at a time
+ * @param field       pattern function
+ * @param duration    ms
+ * @param frame       shortest time between two frames (ms), longer while the last move runs
+*/
+void play_field(t_field field, uint32_t duration, uint32_t frame);
+
+/**
+ * Reveals a pose in waves, see wavefront.h
+ * @param target      pose to reach
+ * @param order       which clocks go first, see wave_orders
+ * @param easing      spread of the waves in time, see wave_easings
+ * @param duration    ms from the first to the last wave
+*/
+void play_wave(const t_full_clock &target, int order, int easing, uint32_t duration);
+
 void setup() {
   Serial.begin(115200);
   Serial.println("\nclockclock24 replica by Vallasc master v1.0");
-  delay(3000);
+  // Boards are already running after a software reset
+  if(!begin_boot_state())
+    delay(3000);
   // Load configuration from EEPROM
   begin_config();
+  if(!tz_set(get_timezone_rule()))
+    tz_set_fixed(get_timezone() * 60);
+  Serial.printf("Time zone: %s\n", tz_get());
 
   Wire.begin(9, 8, 100000);
   pixels.begin();            // Initialise la LED
@@ -123,117 +263,293 @@ void setup() {
   pixels.setPixelColor(0, pixels.Color(255, 0, 0)); // Rouge
   pixels.show();
 
+  // Resume from where the hands are instead of assuming 6h00
+  sync_clock_state();
+  set_all_idle_timeout(get_driver_idle_timeout());
+  for(int i = 0; i < 8 && !is_stopped; i++)
+  {
+    // Drivers were left disabled by a sleep period, show_time() re-enables them
+    t_board_status status;
+    if(read_board_status(i, status) && !(status.flags & STATUS_DRIVERS_ENABLED))
+      is_stopped = true;
+  }
+  if(is_warm_boot() && get_boot_state()->epoch_ms > 0)
+  {
+    // Approximate, NTP corrects it on the first round
+    time_base_set(get_boot_state()->epoch_ms + millis());
+    last_hour = get_boot_state()->hour;
+    last_minute = get_boot_state()->minute;
+    Serial.printf("Time restored, showing %02d:%02d\n", last_hour, last_minute);
+  }
+
   if(get_connection_mode() == HOTSPOT)
-    wifi_create_AP("ClockClock 24", "clockclock24");
-  else if( !wifi_connect(get_ssid(), get_password(), "clockclock24") )
   {
-    set_connection_mode(HOTSPOT);
     wifi_create_AP("ClockClock 24", "clockclock24");
+    set_wifi_status_led(HOTSPOT);
   }
-
-  if(get_connection_mode() == EXT_CONN)
+  else
   {
-    // Initialize NTP
+    // Connects in background, falls back to the access point while the network is unreachable
+    wifi_begin(get_ssid(), get_password(), "clockclock24", "ClockClock 24");
+    // Initialize NTP, queries run in background from the NTP task
     begin_NTP();
-    setSyncProvider(get_NTP_time);
-    // Sync every 30 minutes
-    setSyncInterval(60 * 30);
   }
-  set_wifi_status_led(get_connection_mode());
+  start_NTP_task();
+  // now() reads the time base, it never waits for a sync
+  setTimeSource(get_NTP_time);
   // Starts web server
   server_start();
+  // Starts pose streaming listener
+  begin_udp_control();
 }
 
 void loop() {
 
-  if(get_connection_mode() == HOTSPOT && is_time_changed_browser())
+  // Without a network the browser is the only time source
+  set_ap_fallback(is_ap_fallback());
+  if(is_time_changed_browser() &&
+    (get_connection_mode() == HOTSPOT || is_ap_fallback() || !time_base_is_set()))
   {
-    t_browser_time browser_time = get_browser_time();
-    setTime(browser_time.hour, 
-      browser_time.minute, 
-      browser_time.second, 
-      browser_time.day, 
-      browser_time.month,  
-      browser_time.year);
+    time_base_set(get_browser_time());
   }
 
-  if(get_connection_mode() == EXT_CONN && get_timezone() != get_ntp_timezone())
+  if(wifi_loop())
+    request_NTP_sync();
+  handle_udp_control();
+  if(is_udp_streaming())
   {
-    set_ntp_timezone(get_timezone());
-    setSyncProvider(get_NTP_time);
+    if(is_stopped)
+    {
+      set_all_drivers_enabled(true);
+      is_stopped = false;
+    }
+    was_streaming = true;
+  }
+  else
+  {
+    if(was_streaming)
+    {
+      // Stream ended, force the current time to be shown again
+      was_streaming = false;
+      last_hour = -1;
+      last_minute = -1;
+    }
+    if(get_clock_mode() != OFF)
+      set_time();
+    else
+    {
+      stop();
+      next_sleep_check = millis();
+    }
   }
-
-  get_clock_mode() != OFF ? set_time() : stop();
 
   update_MDNS();
   handle_webclient();
+  config_loop();
+  save_boot_time();
+  sync_bus_time();
+  wake_drivers_loop();
+}
+
+void wake_drivers()
+{
+  wake_board = 0;
+  wake_board_ms = millis() - DRIVER_WAKE_STAGGER;
+  wake_drivers_loop();
+}
+
+void wake_drivers_loop()
+{
+  if(wake_board >= 8 || millis() - wake_board_ms < DRIVER_WAKE_STAGGER)
+    return;
+  set_board_drivers_enabled(wake_board++, true);
+  wake_board_ms = millis();
+}
+
+void sync_bus_time()
+{
+  static uint32_t last_beacon = 0;
+  if(millis() - last_beacon < SYNC_BEACON_INTERVAL)
+    return;
+  last_beacon = millis();
+  send_sync_beacon();
 }
 
 void set_time()
 {
-  int day_week = (weekday() + 5) % 7;
-  if(get_sleep_time(day_week, hour()))
+  // Nothing can change before the next sleep transition
+  if(is_stopped && (int32_t)(millis() - next_sleep_check) < 0)
+    return;
+  // Wait for the first NTP answer or browser time instead of showing 00:00
+  if(get_connection_mode() == EXT_CONN && timeStatus() == timeNotSet)
+    return;
+
+  // Read the clock once, the minute may roll over between calls
+  tmElements_t now_tm;
+  breakTime(now(), now_tm);
+  int day_week = (now_tm.Wday + 5) % 7;
+  if(get_sleep_time(day_week, now_tm.Hour))
+  {
     stop();
-  else if(hour() != last_hour || minute() != last_minute)
+    int minutes = get_next_sleep_transition(day_week, now_tm.Hour * 60 + now_tm.Minute);
+    int32_t wake_in = minutes < 0 ? SLEEP_CHECK_INTERVAL : (minutes * 60 - now_tm.Second) * 1000;
+    if(wake_in <= DRIVER_WAKE_LEAD && !drivers_prespun)
+    {
+      // Spin up the drivers so the first time display is not late
+      wake_drivers();
+      drivers_prespun = true;
+    }
+    else if(wake_in > DRIVER_WAKE_LEAD && drivers_prespun)
+    {
+      // Schedule changed in the meantime, keep sleeping
+      wake_board = 8;
+      set_all_drivers_enabled(false);
+      drivers_prespun = false;
+    }
+    int32_t check_in = wake_in > DRIVER_WAKE_LEAD ? wake_in - DRIVER_WAKE_LEAD : wake_in;
+    next_sleep_check = millis() + constrain(check_in, (int32_t)100, (int32_t)SLEEP_CHECK_INTERVAL);
+  }
+  else
   {
-    // Re-enable drivers if coming from stopped state
-    if(is_stopped)
+    // Start early so that the time pose lands on the minute boundary
+    int mode = get_clock_mode();
+    int32_t lead = mode < OFF ? constrain(mode_lead_ms[mode], (int32_t)0, (int32_t)MAX_MODE_LEAD) : 0;
+    time_t target = (time_t)((local_now_ms() + lead) / 60000) * 60;
+    tmElements_t target_tm;
+    breakTime(target, target_tm);
+    if(target_tm.Hour != last_hour || target_tm.Minute != last_minute)
+      show_time(mode, target_tm.Hour, target_tm.Minute, (int64_t)target * 1000);
+    else if(!is_stopped && get_driver_idle_timeout() > 0)
     {
-      set_all_drivers_enabled(true);
-      delay(500); // Wait for all drivers to be fully enabled before sending positions
+      // Wake the idle motors just before the next animation, instead of on its first step
+      time_t wake = (time_t)((local_now_ms() + lead + DRIVER_IDLE_WAKE_LEAD) / 60000) * 60;
+      if(wake != target && wake != drivers_woken_for)
+      {
+        wake_drivers();
+        drivers_woken_for = wake;
+      }
     }
-    is_stopped = false;
-    last_hour = hour();
-    last_minute = minute();
-    switch(get_clock_mode())
+  }
+}
+
+void show_time(int mode, int h, int m, int64_t target_ms)
+{
+  // Re-enable drivers if coming from stopped state
+  if(is_stopped && !drivers_prespun)
+  {
+    // Wait for all drivers to be fully enabled before sending positions
+    for(int i = 0; i < 8; i++)
     {
-      case LAZY:
-        set_lazy();
-        break;
-      case FUN:
-        set_fun();
-        break;
-      case WAVES:
-        set_waves();
-        break;
-      case SPINNING:
-        set_spinning();
-        break;
-      case SQUARES:
-        set_squares();
-        break;
-      case SYMMETRICAL:
-        set_symmetrical();
-        break;
-      case WIND:
-        set_wind();
-        break;
-      case CASCADE:
-        set_cascade();
-        break;
-      case FIREWORK:
-        set_firework();
-        break;
-      case OBLIQUES:
-        set_obliques();
-        break;
-      case RIPPLE:
-        set_ripple();
-        break;
-      case BREATHE:
-        set_breathe();
-        break;
-      case RAIN:
-        set_rain();
-        break;
-      case HEARTBEAT:
-        set_heartbeat();
-        break;
-      case DANCE:
-        set_dance();
-        break;
+      set_board_drivers_enabled(i, true);
+      delay(DRIVER_WAKE_STAGGER);
     }
+    wake_board = 8;
+  }
+  is_stopped = false;
+  drivers_prespun = false;
+  last_hour = h;
+  last_minute = m;
+  get_boot_state()->hour = -1;
+  get_boot_state()->minute = -1;
+  save_boot_state();
+  uint32_t start = millis();
+  reset_peak_load();
+  switch(mode)
+  {
+    case LAZY:
+      set_lazy();
+      break;
+    case FUN:
+      set_fun();
+      break;
+    case WAVES:
+      set_waves();
+      break;
+    case SPINNING:
+      set_spinning();
+      break;
+    case SQUARES:
+      set_squares();
+      break;
+    case SYMMETRICAL:
+      set_symmetrical();
+      break;
+    case WIND:
+      set_wind();
+      break;
+    case CASCADE:
+      set_cascade();
+      break;
+    case FIREWORK:
+      set_firework();
+      break;
+    case OBLIQUES:
+      set_obliques();
+      break;
+    case RIPPLE:
+      set_ripple();
+      break;
+    case BREATHE:
+      set_breathe();
+      break;
+    case RAIN:
+      set_rain();
+      break;
+    case HEARTBEAT:
+      set_heartbeat();
+      break;
+    case DANCE:
+      set_dance();
+      break;
+  }
+  log_arrival(mode, start, target_ms);
+  log_peak_load(mode);
+  // Hands show the time only once the animation is over
+  get_boot_state()->hour = h;
+  get_boot_state()->minute = m;
+  save_boot_state();
+}
+
+int64_t local_now_ms()
+{
+  if(time_base_is_set())
+  {
+    int64_t utc_ms = time_base_now_ms();
+    return utc_ms + (int64_t)tz_offset_at((time_t)(utc_ms / 1000)) * 1000;
   }
+  return (int64_t)now() * 1000;
+}
+
+void save_boot_time()
+{
+  static uint32_t last_save = 0;
+  if(!time_base_is_set() || millis() - last_save < 1000)
+    return;
+  last_save = millis();
+  get_boot_state()->epoch_ms = time_base_now_ms();
+  save_boot_state();
+}
+
+void log_arrival(int mode, uint32_t start, int64_t target_ms)
+{
+  if(mode >= OFF)
+    return;
+  uint32_t transition = get_last_transition_ms();
+  int32_t predicted_skew = (int32_t)(local_now_ms() + transition - target_ms);
+  int32_t estimated = (int32_t)(millis() - start + transition);
+  Serial.printf("Predicted arrival skew: %ld ms (lead %ld ms, estimated %ld ms)\n",
+    (long)predicted_skew, (long)mode_lead_ms[mode], (long)estimated);
+  // Smooth out random modes and changing digits
+  mode_lead_ms[mode] += (estimated - mode_lead_ms[mode]) / 4;
+}
+
+void log_peak_load(int mode)
+{
+  if(mode >= OFF)
+    return;
+  save_peak_load(mode);
+  Serial.printf("Peak load: %lu mA (budget %lu mA)\n",
+    (unsigned long)get_peak_load(), (unsigned long)get_power_budget());
 }
 
 void set_lazy()
@@ -248,8 +564,11 @@ void set_fun()
 {
   set_speed(400);
   set_acceleration(150);
+  // One full turn, all hands the same way, whichever way ends first
   set_direction(CLOCKWISE2);
+  set_direction_style(STYLE_ONE_WAY);
   set_clock_time(last_hour, last_minute);
+  set_direction_style(STYLE_FIXED);
 }
 
 void set_waves()
@@ -262,12 +581,7 @@ void set_waves()
   set_speed(400);
   set_acceleration(100);
   set_direction(CLOCKWISE2);
-  t_full_clock clock = get_clock_state_from_time(last_hour, last_minute);
-  for (int i = 0; i <8; i++)
-  {
-    set_half_digit(i, clock.digit[i/2].halfs[i%2]);
-    delay(400);
-  }
+  play_wave(get_clock_state_from_time(last_hour, last_minute), WAVE_LEFT_RIGHT, EASE_LINEAR, 2800);
 }
 
 void stop()
@@ -277,11 +591,15 @@ void stop()
     is_stopped = true;
     last_hour = -1;
     last_minute = -1;
+    get_boot_state()->hour = -1;
+    get_boot_state()->minute = -1;
+    save_boot_state();
     set_direction(MIN_DISTANCE);
     set_speed(200);
     set_acceleration(100);
     set_clock(d_stop);
     // Request drivers disable (will happen when motors reach position)
+    wake_board = 8;
     set_all_drivers_enabled(false);
   }
 }
@@ -290,17 +608,56 @@ void _delay(int value)
 {
   for (int i = 0; i <value/100; i++)
   {
+    if(wifi_loop())
+      request_NTP_sync();
     update_MDNS();
     handle_webclient();
+    config_loop();
+    wake_drivers_loop();
     delay(value/100);
   }
 }
 
+void play_field(t_field field, uint32_t duration, uint32_t frame)
+{
+  uint32_t start = millis();
+  while (millis() - start < duration)
+  {
+    set_field(field, millis() - start);
+    // Boards only take a new target once the hand stopped, a frame sent
+    // earlier would be skipped
+    uint32_t next = millis() + max(frame, get_last_transition_ms());
+    while ((int32_t)(millis() - next) < 0)
+      _delay(100);
+  }
+}
+
 // ============================================
 // NEW CHOREOGRAPHIES
 // See docs/CHOREOGRAPHIES.md for documentation
 // ============================================
 
+void play_wave(const t_full_clock &target, int order, int easing, uint32_t duration)
+{
+  t_wave_step steps[WAVE_MAX_STEPS];
+  int count = plan_wave(order, easing, duration, steps);
+  if(count == 0)
+    return;
+  // Directions planned for the whole pose, not step by step
+  t_half_digit frames[8];
+  plan_pose_frames(target, frames);
+  // Uploaded up front, the boards start each step on the bus time
+  send_sync_beacon();
+  uint32_t start = get_bus_time() + (count * WAVE_UPLOAD_MS + WAVE_UPLOAD_MARGIN) * 1000;
+  for (int i = 0; i < count; i++)
+    set_half_digit_clocks_at(steps[i].board, frames[steps[i].board], steps[i].clocks,
+      start + steps[i].at * 1000);
+  // Callers time their next move from the last step
+  uint32_t end = start + steps[count - 1].at * 1000;
+  while ((int32_t)(get_bus_time() - end) < 0)
+    _delay(100);
+}
+
 void set_spinning()
 {
   // Phase 1: All hands pointing up (0°) - progressive column by column
@@ -309,24 +666,16 @@ void set_spinning()
   set_direction(CLOCKWISE);
 
   // Progressive reveal from left to right
-  t_full_clock target_up = d_spin_up;
-  for (int i = 0; i < 8; i++)
-  {
-    set_half_digit(i, target_up.digit[i/2].halfs[i%2]);
-    _delay(300);
-  }
+  play_wave(d_spin_up, WAVE_LEFT_RIGHT, EASE_LINEAR, 2100);
   _delay(2000);
 
-  // Phase 2: Rotate to down (180°) - all together with slower speed
-  set_speed(400);
-  set_clock(d_spin_down);
-  _delay(5000);
-
-  // Phase 3: Rotate back to up (360°/0°)
+  // Phase 2: Endless rotation, all hands locked on the bus time
+  set_speed(SPIN_SPEED);
+  set_direction(ROTATE_CLOCKWISE);
   set_clock(d_spin_up);
-  _delay(5000);
+  _delay(SPIN_DURATION);
 
-  // Final: Transition to time
+  // Final: Transition to time, rotating hands brake clockwise onto it
   set_speed(400);
   set_acceleration(150);
   set_direction(MIN_DISTANCE);
@@ -339,31 +688,12 @@ void set_squares()
   set_acceleration(300);
   set_direction(CLOCKWISE);
 
-  // Phase 1: Start with all horizontal (like WAVES)
+  // Phase 1: Start with all vertical (like WAVES)
   set_clock(d_IIII);
   _delay(3000);
 
   // Phase 2: Progressive reveal of squares pattern from center outward
-  t_full_clock target = d_squares;
-
-  // Center columns first (3, 4)
-  set_half_digit(3, target.digit[1].halfs[1]);
-  set_half_digit(4, target.digit[2].halfs[0]);
-  _delay(1500);
-
-  // Next ring (2, 5)
-  set_half_digit(2, target.digit[1].halfs[0]);
-  set_half_digit(5, target.digit[2].halfs[1]);
-  _delay(1500);
-
-  // Outer ring (1, 6)
-  set_half_digit(1, target.digit[0].halfs[1]);
-  set_half_digit(6, target.digit[3].halfs[0]);
-  _delay(1500);
-
-  // Outermost (0, 7)
-  set_half_digit(0, target.digit[0].halfs[0]);
-  set_half_digit(7, target.digit[3].halfs[1]);
+  play_wave(d_squares, WAVE_CENTER_OUT, EASE_LINEAR, 4500);
   _delay(3000);
 
   // Final: Transition to time
@@ -379,52 +709,17 @@ void set_symmetrical()
   set_acceleration(200);
   set_direction(MIN_DISTANCE);
 
-  // Phase 1: Start horizontal
+  // Phase 1: Start vertical
   set_clock(d_IIII);
   _delay(3000);
 
   // Phase 2: Progressive diverge - outer columns first, then inner
   // Left side points left, right side points right
-  t_full_clock sym_diverge = {digit_sym_left, digit_sym_left, digit_sym_right, digit_sym_right};
-
-  // Outer columns (0, 7)
-  set_half_digit(0, sym_diverge.digit[0].halfs[0]);
-  set_half_digit(7, sym_diverge.digit[3].halfs[1]);
-  _delay(1000);
-
-  // Next (1, 6)
-  set_half_digit(1, sym_diverge.digit[0].halfs[1]);
-  set_half_digit(6, sym_diverge.digit[3].halfs[0]);
-  _delay(1000);
-
-  // Next (2, 5)
-  set_half_digit(2, sym_diverge.digit[1].halfs[0]);
-  set_half_digit(5, sym_diverge.digit[2].halfs[1]);
-  _delay(1000);
-
-  // Center (3, 4)
-  set_half_digit(3, sym_diverge.digit[1].halfs[1]);
-  set_half_digit(4, sym_diverge.digit[2].halfs[0]);
+  play_wave(d_sym_diverge, WAVE_EDGES_IN, EASE_LINEAR, 3000);
   _delay(3000);
 
   // Phase 3: Converge - progressive from center outward
-  t_full_clock sym_converge = {digit_sym_right, digit_sym_right, digit_sym_left, digit_sym_left};
-
-  // Center first
-  set_half_digit(3, sym_converge.digit[1].halfs[1]);
-  set_half_digit(4, sym_converge.digit[2].halfs[0]);
-  _delay(1000);
-
-  set_half_digit(2, sym_converge.digit[1].halfs[0]);
-  set_half_digit(5, sym_converge.digit[2].halfs[1]);
-  _delay(1000);
-
-  set_half_digit(1, sym_converge.digit[0].halfs[1]);
-  set_half_digit(6, sym_converge.digit[3].halfs[0]);
-  _delay(1000);
-
-  set_half_digit(0, sym_converge.digit[0].halfs[0]);
-  set_half_digit(7, sym_converge.digit[3].halfs[1]);
+  play_wave(d_sym_converge, WAVE_CENTER_OUT, EASE_LINEAR, 3000);
   _delay(3000);
 
   // Final: Transition to time
@@ -433,55 +728,30 @@ void set_symmetrical()
   set_clock_time(last_hour, last_minute);
 }
 
+// Grass blades leaning right as gusts cross the grid from the left
+static t_clockl wind_field(int col, int row, uint32_t t)
+{
+  int32_t lean = -(45 + field_wave(col, t, WIND_PERIOD, FIELD_COLUMNS, 45)) / 2;
+  return {field_angle(90 + lean), field_angle(270 + lean)};
+}
+
 void set_wind()
 {
   set_speed(600);
   set_acceleration(250);
   set_direction(CLOCKWISE);
 
-  // Phase 1: All horizontal
+  // Phase 1: All upright
   set_clock(d_IIII);
   _delay(3000);
 
-  // Phase 2: Progressive tilt from left to right (wind blowing)
-  // Wave effect - columns tilt progressively like grass in wind
-  for (int wave = 0; wave < 2; wave++)
-  {
-    // Wave passes through - tilt columns progressively
-    for (int col = 0; col < 8; col++)
-    {
-      // Tilt this column - diagonal lines pointing down-right
-      // h=225 (down-left), m=45 (up-right) creates a diagonal /
-      t_half_digitl tilted = {0};
-      for (int row = 0; row < 3; row++)
-      {
-        tilted.clocks[row].angle_h = 225;  // down-left
-        tilted.clocks[row].angle_m = 45;   // up-right
-      }
-      set_half_digit(col, tilted);
-      _delay(300);
-    }
-
-    // Return to horizontal progressively
-    _delay(1000);
-    for (int col = 0; col < 8; col++)
-    {
-      t_half_digitl horizontal = {0};
-      for (int row = 0; row < 3; row++)
-      {
-        horizontal.clocks[row].angle_h = 270;  // left
-        horizontal.clocks[row].angle_m = 90;   // right
-      }
-      set_half_digit(col, horizontal);
-      _delay(300);
-    }
-    _delay(1500);
-  }
+  // Phase 2: Three gusts, small moves back and forth
+  set_direction(MIN_DISTANCE);
+  play_field(wind_field, 3 * WIND_PERIOD, FIELD_FRAME);
 
   // Final: Transition to time
   set_speed(400);
   set_acceleration(150);
-  set_direction(MIN_DISTANCE);
   set_clock_time(last_hour, last_minute);
 }
 
@@ -496,44 +766,13 @@ void set_cascade()
   set_acceleration(300);
   set_direction(CLOCKWISE);
 
-  t_half_digitl vertical_up = {0};
-  for (int row = 0; row < 3; row++)
-  {
-    vertical_up.clocks[row].angle_h = 0;    // up
-    vertical_up.clocks[row].angle_m = 180;  // down
-  }
-  for (int hd = 0; hd < 8; hd++)
-    set_half_digit(hd, vertical_up);
+  set_clock(fill_clock(fill_digit(cell(0, 180))));
   _delay(3000);
 
   // Phase 2: Cascade down row by row - top row reveals first
-  for (int hd = 0; hd < 8; hd++)
-  {
-    t_half_digitl row0_half = {0};
-    row0_half.clocks[0] = target.digit[hd/2].halfs[hd%2].clocks[0];
-    // Keep rows 1,2 as vertical lines
-    row0_half.clocks[1].angle_h = 0;
-    row0_half.clocks[1].angle_m = 180;
-    row0_half.clocks[2].angle_h = 0;
-    row0_half.clocks[2].angle_m = 180;
-    set_half_digit(hd, row0_half);
-  }
-  _delay(3000);
+  play_wave(target, WAVE_ROWS, EASE_LINEAR, 6000);
 
-  // Row 1 (middle) reveals
-  for (int hd = 0; hd < 8; hd++)
-  {
-    t_half_digitl row1_half = {0};
-    row1_half.clocks[0] = target.digit[hd/2].halfs[hd%2].clocks[0];
-    row1_half.clocks[1] = target.digit[hd/2].halfs[hd%2].clocks[1];
-    // Keep row 2 as vertical line
-    row1_half.clocks[2].angle_h = 0;
-    row1_half.clocks[2].angle_m = 180;
-    set_half_digit(hd, row1_half);
-  }
-  _delay(3000);
-
-  // Row 2 (bottom) - complete the cascade
+  // Time is already shown, nothing moves
   set_speed(400);
   set_acceleration(150);
   set_direction(MIN_DISTANCE);
@@ -554,24 +793,8 @@ void set_firework()
   set_acceleration(400);
   set_direction(CLOCKWISE);
 
-  // Center columns first (half-digits 3,4) - the spark
-  set_half_digit(3, digit_firework_inner_left.halfs[1]);
-  set_half_digit(4, digit_firework_inner_right.halfs[0]);
-  _delay(1500);
-
-  // Next ring (half-digits 2 and 5) - explosion expands
-  set_half_digit(2, digit_firework_inner_left.halfs[0]);
-  set_half_digit(5, digit_firework_inner_right.halfs[1]);
-  _delay(1500);
-
-  // Outer ring (half-digits 1 and 6)
-  set_half_digit(1, digit_firework_outer_left.halfs[1]);
-  set_half_digit(6, digit_firework_outer_right.halfs[0]);
-  _delay(1500);
-
-  // Outermost (half-digits 0 and 7) - full explosion
-  set_half_digit(0, digit_firework_outer_left.halfs[0]);
-  set_half_digit(7, digit_firework_outer_right.halfs[1]);
+  // The spark in the middle, the explosion speeding up towards the edges
+  play_wave(d_firework, WAVE_CENTER_OUT, EASE_IN, 4500);
   _delay(3000);
 
   // Phase 3: Fade - return to neutral before time
@@ -588,43 +811,32 @@ void set_firework()
 // ============================================
 // OBLIQUES - Diagonal lines rotation (progressive wave)
 // ============================================
+
+// Lines turning clockwise, each column starting a little after the one on its left
+static t_clockl obliques_field(int col, int row, uint32_t t)
+{
+  uint32_t start = col * OBLIQUES_LAG;
+  int32_t turn = t > start ? (int32_t)((t - start) * 180 / OBLIQUES_PERIOD) : 0;
+  return {field_angle(90 - turn), field_angle(270 - turn)};
+}
+
 void set_obliques()
 {
   set_speed(600);
   set_acceleration(300);
   set_direction(CLOCKWISE);
 
-  // Phase 1: Start horizontal
+  // Phase 1: Start upright
   set_clock(d_IIII);
   _delay(3000);
 
-  // Phase 2: Progressive diagonal rotation - wave from left to right
-  // Each column rotates to diagonal progressively
-  t_full_clock target_br = d_obliques_br;
-  for (int col = 0; col < 8; col++)
-  {
-    set_half_digit(col, target_br.digit[col/2].halfs[col%2]);
-    _delay(400);
-  }
-  _delay(2000);
-
-  // Phase 3: Rotate all together to next diagonal
-  set_clock(d_obliques_tr);
-  _delay(4000);
-
-  // Phase 4: Progressive return - wave from right to left
-  t_full_clock target_tl = d_obliques_tl;
-  for (int col = 7; col >= 0; col--)
-  {
-    set_half_digit(col, target_tl.digit[col/2].halfs[col%2]);
-    _delay(400);
-  }
-  _delay(2000);
+  // Phase 2: Lines tilt column by column, then keep turning as a wave
+  set_direction(MIN_DISTANCE);
+  play_field(obliques_field, 3 * OBLIQUES_PERIOD, FIELD_FRAME);
 
   // Final: Transition to time
   set_speed(400);
   set_acceleration(150);
-  set_direction(MIN_DISTANCE);
   set_clock_time(last_hour, last_minute);
 }
 
@@ -641,47 +853,12 @@ void set_ripple()
   set_clock(d_stop);
   _delay(3000);
 
-  // Phase 2: Ripple expands from center outward - progressive
-  t_full_clock ripple_out = d_ripple_out;
-
-  // Center first (columns 3, 4)
-  set_half_digit(3, ripple_out.digit[1].halfs[1]);
-  set_half_digit(4, ripple_out.digit[2].halfs[0]);
-  _delay(1500);
-
-  // Next ring (columns 2, 5)
-  set_half_digit(2, ripple_out.digit[1].halfs[0]);
-  set_half_digit(5, ripple_out.digit[2].halfs[1]);
-  _delay(1500);
-
-  // Next ring (columns 1, 6)
-  set_half_digit(1, ripple_out.digit[0].halfs[1]);
-  set_half_digit(6, ripple_out.digit[3].halfs[0]);
-  _delay(1500);
-
-  // Outer ring (columns 0, 7)
-  set_half_digit(0, ripple_out.digit[0].halfs[0]);
-  set_half_digit(7, ripple_out.digit[3].halfs[1]);
+  // Phase 2: Ripple expands from center outward, slowing down like a ring on water
+  play_wave(d_ripple_out, WAVE_CENTER_OUT, EASE_OUT, 4500);
   _delay(2000);
 
   // Phase 3: Ripple contracts inward - progressive
-  t_full_clock ripple_in = d_ripple_in;
-
-  // Outer first
-  set_half_digit(0, ripple_in.digit[0].halfs[0]);
-  set_half_digit(7, ripple_in.digit[3].halfs[1]);
-  _delay(1200);
-
-  set_half_digit(1, ripple_in.digit[0].halfs[1]);
-  set_half_digit(6, ripple_in.digit[3].halfs[0]);
-  _delay(1200);
-
-  set_half_digit(2, ripple_in.digit[1].halfs[0]);
-  set_half_digit(5, ripple_in.digit[2].halfs[1]);
-  _delay(1200);
-
-  set_half_digit(3, ripple_in.digit[1].halfs[1]);
-  set_half_digit(4, ripple_in.digit[2].halfs[0]);
+  play_wave(d_ripple_in, WAVE_EDGES_IN, EASE_LINEAR, 3600);
   _delay(2000);
 
   // Final: Transition to time
@@ -699,47 +876,16 @@ void set_breathe()
   set_acceleration(200);
   set_direction(MIN_DISTANCE);
 
-  // Phase 1: Start neutral (horizontal)
+  // Phase 1: Start neutral (vertical)
   set_clock(d_breathe_neutral);
   _delay(3000);
 
   // Phase 2: Inhale - progressive expansion from center outward
-  t_full_clock expand = d_breathe_expand;
-
-  // Center expands first
-  set_half_digit(3, expand.digit[1].halfs[1]);
-  set_half_digit(4, expand.digit[2].halfs[0]);
-  _delay(800);
-
-  set_half_digit(2, expand.digit[1].halfs[0]);
-  set_half_digit(5, expand.digit[2].halfs[1]);
-  _delay(800);
-
-  set_half_digit(1, expand.digit[0].halfs[1]);
-  set_half_digit(6, expand.digit[3].halfs[0]);
-  _delay(800);
-
-  set_half_digit(0, expand.digit[0].halfs[0]);
-  set_half_digit(7, expand.digit[3].halfs[1]);
+  play_wave(d_breathe_expand, WAVE_CENTER_OUT, EASE_IN_OUT, 2400);
   _delay(2500);
 
   // Phase 3: Exhale - progressive contraction from outer inward
-  t_full_clock contract = d_breathe_contract;
-
-  set_half_digit(0, contract.digit[0].halfs[0]);
-  set_half_digit(7, contract.digit[3].halfs[1]);
-  _delay(800);
-
-  set_half_digit(1, contract.digit[0].halfs[1]);
-  set_half_digit(6, contract.digit[3].halfs[0]);
-  _delay(800);
-
-  set_half_digit(2, contract.digit[1].halfs[0]);
-  set_half_digit(5, contract.digit[2].halfs[1]);
-  _delay(800);
-
-  set_half_digit(3, contract.digit[1].halfs[1]);
-  set_half_digit(4, contract.digit[2].halfs[0]);
+  play_wave(d_breathe_contract, WAVE_EDGES_IN, EASE_IN_OUT, 2400);
   _delay(2500);
 
   // Phase 4: Return to neutral
@@ -755,63 +901,33 @@ void set_breathe()
 // ============================================
 // RAIN - Vertical falling pattern (row-by-row)
 // ============================================
+
+// Drops falling down each column, a flat clock stands up while a drop passes.
+// Columns are shifted at random so drops don't fall in lines
+static t_clockl rain_field(int col, int row, uint32_t t)
+{
+  uint32_t shift = (uint32_t)(field_noise(col, 0, 0, 1) + FIELD_ONE) * RAIN_PERIOD / (2 * FIELD_ONE);
+  int32_t drop = field_wave(row, t + shift, RAIN_PERIOD, 2 * FIELD_ROWS, FIELD_ONE);
+  // Top third of the wave only, a drop covers two rows
+  int32_t turn = drop > FIELD_ONE / 2 ? 90 * (2 * drop - FIELD_ONE) / FIELD_ONE : 0;
+  return {field_angle(turn), field_angle(180 + turn)};
+}
+
 void set_rain()
 {
   set_speed(700);
   set_acceleration(350);
   set_direction(CLOCKWISE);
 
-  // Phase 1: All vertical lines pointing up (clouds/source)
-  // h=0 (up), m=180 (down) = vertical line |
-  t_half_digitl vertical = {0};
-  for (int row = 0; row < 3; row++)
-  {
-    vertical.clocks[row].angle_h = 0;    // up
-    vertical.clocks[row].angle_m = 180;  // down
-  }
-  for (int hd = 0; hd < 8; hd++)
-    set_half_digit(hd, vertical);
+  // Phase 1: All flat (clouds)
+  set_clock(fill_clock(fill_digit(cell(0, 180))));
   _delay(3000);
 
-  // Phase 2: Rain falls - row by row from top to bottom
-  // First row falls (top) - becomes horizontal
-  for (int hd = 0; hd < 8; hd++)
-  {
-    t_half_digitl drop = {0};
-    drop.clocks[0].angle_h = 270;  // Top row horizontal (left)
-    drop.clocks[0].angle_m = 90;   // (right)
-    drop.clocks[1].angle_h = 0;    // Middle still vertical
-    drop.clocks[1].angle_m = 180;
-    drop.clocks[2].angle_h = 0;    // Bottom still vertical
-    drop.clocks[2].angle_m = 180;
-    set_half_digit(hd, drop);
-  }
-  _delay(2500);
-
-  // Second row falls (middle)
-  for (int hd = 0; hd < 8; hd++)
-  {
-    t_half_digitl drop = {0};
-    drop.clocks[0].angle_h = 270;
-    drop.clocks[0].angle_m = 90;
-    drop.clocks[1].angle_h = 270;  // Middle row now horizontal
-    drop.clocks[1].angle_m = 90;
-    drop.clocks[2].angle_h = 0;    // Bottom still vertical
-    drop.clocks[2].angle_m = 180;
-    set_half_digit(hd, drop);
-  }
-  _delay(2500);
-
-  // Third row falls (bottom) - all horizontal = splash
-  set_clock(d_IIII);
-  _delay(3000);
-
-  // Phase 3: Reset to vertical and repeat
-  for (int hd = 0; hd < 8; hd++)
-    set_half_digit(hd, vertical);
-  _delay(2000);
+  // Phase 2: Rain falls
+  set_direction(MIN_DISTANCE);
+  play_field(rain_field, 5 * RAIN_PERIOD, FIELD_FRAME);
 
-  // Quick falling - all at once to horizontal
+  // Phase 3: Everything lands at once
   set_speed(800);
   set_clock(d_IIII);
   _delay(3000);
@@ -819,7 +935,6 @@ void set_rain()
   // Final: Transition to time
   set_speed(400);
   set_acceleration(150);
-  set_direction(MIN_DISTANCE);
   set_clock_time(last_hour, last_minute);
 }
 
@@ -908,18 +1023,17 @@ void set_dance()
   _delay(3000);
 
   // Chain the random shapes
-  int last_shape = -1;
   for (int i = 0; i < num_shapes; i++)
   {
-    // Pick a shape different from the last one
-    int shape_idx;
+    // Pick a shape that moves some clocks from the current pose
+    t_pose current = get_last_pose();
+    t_pose shape;
     do {
-      shape_idx = random(0, NUM_DANCE_SHAPES);
-    } while (shape_idx == last_shape);
-    last_shape = shape_idx;
+      shape = pose_from_clock(*dance_shapes[random(0, NUM_DANCE_SHAPES)]);
+    } while (pose_diff(current, shape) == 0);
 
     // Apply the shape
-    set_clock(*dance_shapes[shape_idx]);
+    set_pose(shape);
 
     // Fixed delay between shapes (4 seconds for motor completion)
     _delay(4000);
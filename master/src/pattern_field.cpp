@@ -0,0 +1,69 @@
+#include "pattern_field.h"
+
+// sin(0..90°) * FIELD_ONE, the other quadrants by symmetry
+static const int16_t _sin_table[91] = {
+  0, 18, 36, 54, 71, 89, 107, 125, 143, 160,
+  178, 195, 213, 230, 248, 265, 282, 299, 316, 333,
+  350, 367, 384, 400, 416, 433, 449, 465, 481, 496,
+  512, 527, 543, 558, 573, 587, 602, 616, 630, 644,
+  658, 672, 685, 698, 711, 724, 737, 749, 761, 773,
+  784, 796, 807, 818, 828, 839, 849, 859, 868, 878,
+  887, 896, 904, 912, 920, 928, 935, 943, 949, 956,
+  962, 968, 974, 979, 984, 989, 994, 998, 1002, 1005,
+  1008, 1011, 1014, 1016, 1018, 1020, 1022, 1023, 1023, 1024,
+  1024
+};
+
+uint16_t field_angle(int32_t angle)
+{
+  angle %= 360;
+  return angle < 0 ? angle + 360 : angle;
+}
+
+int16_t field_sin(int32_t angle)
+{
+  uint16_t a = field_angle(angle);
+  if (a <= 90)
+    return _sin_table[a];
+  if (a <= 180)
+    return _sin_table[180 - a];
+  if (a <= 270)
+    return -_sin_table[a - 180];
+  return -_sin_table[360 - a];
+}
+
+int16_t field_cos(int32_t angle)
+{
+  return field_sin(angle + 90);
+}
+
+uint16_t field_phase(uint32_t t, uint32_t period)
+{
+  return (uint64_t)(t % period) * 360 / period;
+}
+
+int32_t field_wave(int position, uint32_t t, uint32_t period, int wavelength, int32_t amplitude)
+{
+  int32_t phase = field_phase(t, period) - position * 360 / wavelength;
+  return amplitude * field_sin(phase) / FIELD_ONE;
+}
+
+// -FIELD_ONE..FIELD_ONE, fixed for a clock and a time slot
+static int32_t lattice(int col, int row, uint32_t slot)
+{
+  uint32_t h = (uint32_t)col * 73856093u ^ (uint32_t)row * 19349663u ^ slot * 83492791u;
+  h ^= h >> 13;
+  h *= 0x5bd1e995u;
+  h ^= h >> 15;
+  return (int32_t)(h % (2 * FIELD_ONE + 1)) - FIELD_ONE;
+}
+
+int32_t field_noise(int col, int row, uint32_t t, uint32_t period)
+{
+  uint32_t slot = t / period;
+  int32_t from = lattice(col, row, slot);
+  int32_t to = lattice(col, row, slot + 1);
+  // Cosine easing, no jump in speed between two slots
+  int32_t blend = (FIELD_ONE - field_cos((t % period) * 180 / period)) / 2;
+  return from + (to - from) * blend / FIELD_ONE;
+}
@@ -0,0 +1,41 @@
+#include "pose.h"
+#include "digit.h"
+
+t_half_digitl pose_column(const t_pose &pose, int col)
+{
+  t_half_digitl half;
+  for (int row = 0; row < POSE_ROWS; row++)
+  {
+    half.clocks[row].angle_h = pose.angle[pose_index(col, row, HAND_H)];
+    half.clocks[row].angle_m = pose.angle[pose_index(col, row, HAND_M)];
+  }
+  return half;
+}
+
+void pose_set_clock(t_pose &pose, int col, int row, const t_clockl &clock)
+{
+  pose.angle[pose_index(col, row, HAND_H)] = clock.angle_h;
+  pose.angle[pose_index(col, row, HAND_M)] = clock.angle_m;
+}
+
+t_pose pose_from_clock(const t_full_clock &clock)
+{
+  t_pose pose;
+  for (int col = 0; col < POSE_COLUMNS; col++)
+    for (int row = 0; row < POSE_ROWS; row++)
+      pose_set_clock(pose, col, row, get_column(clock, col).clocks[row]);
+  return pose;
+}
+
+uint32_t pose_diff(const t_pose &a, const t_pose &b)
+{
+  uint32_t moved = 0;
+  for (int i = 0; i < POSE_CLOCKS; i++)
+  {
+    uint16_t ah = a.angle[i * 2], am = a.angle[i * 2 + 1];
+    uint16_t bh = b.angle[i * 2], bm = b.angle[i * 2 + 1];
+    if (!((ah == bh && am == bm) || (ah == bm && am == bh)))
+      moved |= 1UL << i;
+  }
+  return moved;
+}
@@ -0,0 +1,76 @@
+#include "power_model.h"
+#include "clock_manager.h"
+
+// Factor of the speed and the acceleration of a move stretched to last
+// seconds, same as stretch_factor() on the slaves
+static float stretch_factor(float steps, float speed, float accel, float seconds)
+{
+  float ramp = speed / accel;
+  if (seconds > ramp)
+  {
+    float factor = steps / (speed * (seconds - ramp));
+    if (factor * speed * speed / accel <= steps)
+      return min(1.0f, factor);
+  }
+  return min(1.0f, 4.0f * steps / (accel * seconds * seconds));
+}
+
+t_power_move plan_power_move(int degrees, int speed, int accel, uint32_t start, uint32_t arrive)
+{
+  t_power_move move = {start, 0, 0, 0};
+  move.duration = estimate_move_ms(degrees, speed, accel);
+  if (move.duration == 0)
+    return move;
+  float steps = (float)degrees * MOTOR_STEPS / 360;
+  float stretched = accel;
+  if (arrive > move.duration)
+  {
+    // Slower ramps draw less, the cruise speed doesn't change the model
+    stretched = accel * stretch_factor(steps, speed, accel, arrive / 1000.0f);
+    move.duration = arrive;
+  }
+  // Triangular profile when the cruise speed is never reached
+  float ramp_s = min((float)speed / accel, sqrtf(steps / stretched));
+  move.ramp = (uint32_t)(1000.0f * ramp_s);
+  move.accel_ma = (uint32_t)(MOTOR_ACCEL_MA * stretched / POWER_ACCEL_REF);
+  return move;
+}
+
+static uint32_t move_load_at(const t_power_move &move, uint32_t t)
+{
+  uint32_t elapsed = t - move.start;
+  if ((int32_t)elapsed < 0 || elapsed >= move.duration)
+    return MOTOR_HOLD_MA;
+  if (elapsed < move.ramp || elapsed >= move.duration - move.ramp)
+    return MOTOR_RUN_MA + move.accel_ma;
+  return MOTOR_RUN_MA;
+}
+
+uint32_t power_load_at(const t_power_move *moves, int count, uint32_t t)
+{
+  uint32_t load = 0;
+  for (int i = 0; i < count; i++)
+    load += move_load_at(moves[i], t);
+  return load;
+}
+
+static bool in_window(uint32_t t, uint32_t from, uint32_t to)
+{
+  return (int32_t)(t - from) >= 0 && (int32_t)(t - to) < 0;
+}
+
+uint32_t power_peak_between(const t_power_move *moves, int count, uint32_t from, uint32_t to)
+{
+  uint32_t peak = power_load_at(moves, count, from);
+  for (int i = 0; i < count; i++)
+  {
+    if (moves[i].duration == 0)
+      continue;
+    // Load steps up at the start and when the braking begins
+    const uint32_t changes[2] = {moves[i].start, moves[i].start + moves[i].duration - moves[i].ramp};
+    for (int j = 0; j < 2; j++)
+      if (in_window(changes[j], from, to))
+        peak = max(peak, power_load_at(moves, count, changes[j]));
+  }
+  return peak;
+}
@@ -0,0 +1,206 @@
+#include "time_base.h"
+
+// Everything a read needs, swapped as a whole under _time_mux: readers
+// never see half an update and never write anything
+typedef struct time_params
+{
+  int64_t base_ms;          // UTC time at base_millis
+  uint32_t base_millis;
+  int32_t drift_ppb;        // oscillator drift compensation
+  int64_t drift_carry;      // fraction of ms not applied yet at base_millis (ms * 1e-9)
+  int32_t slew;             // correction still to apply at base_millis
+  uint32_t slew_carry;      // elapsed time not yet converted into a slew step
+  bool set;
+} t_time_params;
+
+static portMUX_TYPE _time_mux = portMUX_INITIALIZER_UNLOCKED;
+static t_time_params _params = {0, 0, 0, 0, 0, 0, false};
+
+// Drift estimate, only touched by the sync side
+bool _drift_known = false;
+// Average error of the drift estimate (ppb)
+int32_t _drift_jitter = TIME_DRIFT_UNKNOWN;
+
+// Sync history, ring buffer
+t_time_sample _history[TIME_HISTORY_SIZE];
+int _history_count = 0;
+int _history_next = 0;
+bool _synced = false;
+uint32_t _sync_millis = 0;
+int32_t _sync_delay = 0;
+
+static t_time_params get_params()
+{
+  portENTER_CRITICAL(&_time_mux);
+  t_time_params params = _params;
+  portEXIT_CRITICAL(&_time_mux);
+  return params;
+}
+
+// Moves the base to now: same time, drift and slew progress folded in
+static t_time_params advance(const t_time_params &params, uint32_t now)
+{
+  t_time_params next = params;
+  uint32_t elapsed = now - params.base_millis;
+  next.base_millis = now;
+  next.base_ms += elapsed;
+
+  int64_t drift = params.drift_carry + (int64_t)elapsed * params.drift_ppb;
+  next.base_ms += drift / 1000000000;
+  next.drift_carry = drift % 1000000000;
+
+  if (params.slew != 0)
+  {
+    uint32_t slew_time = params.slew_carry + elapsed;
+    int32_t step = slew_time / TIME_SLEW_RATIO;
+    next.slew_carry = slew_time % TIME_SLEW_RATIO;
+    if (step > abs(params.slew))
+      step = abs(params.slew);
+    if (params.slew < 0)
+      step = -step;
+    next.base_ms += step;
+    next.slew -= step;
+  }
+  return next;
+}
+
+bool time_base_is_set()
+{
+  return get_params().set;
+}
+
+int64_t time_base_now_ms()
+{
+  return advance(get_params(), millis()).base_ms;
+}
+
+time_t time_base_now()
+{
+  return time_base_now_ms() / 1000;
+}
+
+void time_base_rebase()
+{
+  // In one piece, a set from another task can't be lost
+  portENTER_CRITICAL(&_time_mux);
+  _params = advance(_params, millis());
+  portEXIT_CRITICAL(&_time_mux);
+}
+
+// Sets the time, called with _time_mux held
+static void set_locked(int64_t epoch_ms, uint32_t now)
+{
+  _params.base_millis = now;
+  _params.base_ms = epoch_ms;
+  _params.drift_carry = 0;
+  _params.slew = 0;
+  _params.slew_carry = 0;
+  _params.set = true;
+}
+
+void time_base_set(int64_t epoch_ms)
+{
+  portENTER_CRITICAL(&_time_mux);
+  set_locked(epoch_ms, millis());
+  portEXIT_CRITICAL(&_time_mux);
+}
+
+void time_base_adjust(int64_t offset_ms)
+{
+  // Read, correction and write in one piece, a set or rebase from another
+  // task can't slip in between
+  portENTER_CRITICAL(&_time_mux);
+  t_time_params params = advance(_params, millis());
+  if (!params.set || offset_ms > TIME_STEP_THRESHOLD || offset_ms < -TIME_STEP_THRESHOLD)
+    set_locked(params.base_ms + offset_ms, params.base_millis);
+  else
+  {
+    params.slew = offset_ms;
+    params.slew_carry = 0;
+    _params = params;
+  }
+  portEXIT_CRITICAL(&_time_mux);
+}
+
+// Updates the drift estimate from the offset accumulated since the last sync
+static void update_drift(int64_t offset_ms, uint32_t interval)
+{
+  if (interval < TIME_DRIFT_MIN_INTERVAL)
+    return;
+  portENTER_CRITICAL(&_time_mux);
+  t_time_params params = advance(_params, millis());
+  // Correction still being slewed is not drift
+  int64_t residual = (offset_ms - params.slew) * 1000000000 / interval;
+  bool rejected = residual > TIME_DRIFT_MAX || residual < -TIME_DRIFT_MAX;
+  if (!rejected)
+  {
+    params.drift_ppb += _drift_known ? residual / 4 : residual;
+    _params = params;
+  }
+  portEXIT_CRITICAL(&_time_mux);
+
+  // Logs and the sync side state stay out of the critical section
+  if (rejected)
+  {
+    Serial.printf("Time: drift sample of %lld ppb rejected\n", residual);
+    return;
+  }
+  _drift_known = true;
+  int32_t error = residual < 0 ? -residual : residual;
+  _drift_jitter += (error - _drift_jitter) / 4;
+  if (_drift_jitter < TIME_DRIFT_FLOOR)
+    _drift_jitter = TIME_DRIFT_FLOOR;
+  Serial.printf("Time: drift %ld ppb (residual %lld ppb)\n", (long)params.drift_ppb, residual);
+}
+
+void time_base_sync(int64_t offset_ms, int64_t delay_ms)
+{
+  uint32_t now = millis();
+  if (_synced && time_base_is_set())
+    update_drift(offset_ms, now - _sync_millis);
+  time_base_adjust(offset_ms);
+
+  _history[_history_next] = {time_base_now_ms(), (int32_t)offset_ms, (int32_t)delay_ms};
+  _history_next = (_history_next + 1) % TIME_HISTORY_SIZE;
+  if (_history_count < TIME_HISTORY_SIZE)
+    _history_count++;
+  _synced = true;
+  _sync_millis = now;
+  _sync_delay = delay_ms;
+}
+
+int32_t time_base_drift_ppb()
+{
+  return get_params().drift_ppb;
+}
+
+int32_t time_base_sync_age()
+{
+  if (!_synced)
+    return -1;
+  return (millis() - _sync_millis) / 1000;
+}
+
+int32_t time_base_error_estimate()
+{
+  if (!_synced)
+    return -1;
+  // Sample error, plus what the drift estimate may have missed since then
+  uint32_t age = millis() - _sync_millis;
+  int64_t error = _sync_delay / 2 + abs(time_base_pending_slew());
+  error += (int64_t)age * _drift_jitter / 1000000000;
+  return (int32_t)error;
+}
+
+int time_base_history(t_time_sample *samples, int max)
+{
+  int count = _history_count < max ? _history_count : max;
+  for (int i = 0; i < count; i++)
+    samples[i] = _history[(_history_next - 1 - i + TIME_HISTORY_SIZE) % TIME_HISTORY_SIZE];
+  return count;
+}
+
+int32_t time_base_pending_slew()
+{
+  return advance(get_params(), millis()).slew;
+}
@@ -0,0 +1,349 @@
+#include "timezone.h"
+
+typedef struct tz_zone
+{
+  const char *name;
+  const char *rule;
+} t_tz_zone;
+
+// IANA names sent by browsers, mapped to their POSIX rule
+const t_tz_zone tz_zones[] PROGMEM = {
+  {"UTC", "UTC0"},
+  {"Europe/London", "GMT0BST,M3.5.0/1,M10.5.0"},
+  {"Europe/Dublin", "IST-1GMT0,M10.5.0,M3.5.0/1"},
+  {"Europe/Lisbon", "WET0WEST,M3.5.0/1,M10.5.0"},
+  {"Europe/Paris", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Brussels", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Amsterdam", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Luxembourg", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Berlin", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Zurich", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Rome", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Madrid", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Vienna", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Stockholm", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Warsaw", "CET-1CEST,M3.5.0,M10.5.0/3"},
+  {"Europe/Athens", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+  {"Europe/Helsinki", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+  {"Europe/Istanbul", "<+03>-3"},
+  {"Europe/Moscow", "MSK-3"},
+  {"Africa/Abidjan", "GMT0"},
+  {"Indian/Reunion", "<+04>-4"},
+  {"Asia/Dubai", "<+04>-4"},
+  {"Asia/Kolkata", "IST-5:30"},
+  {"Asia/Shanghai", "CST-8"},
+  {"Asia/Singapore", "<+08>-8"},
+  {"Asia/Tokyo", "JST-9"},
+  {"Australia/Perth", "AWST-8"},
+  {"Australia/Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3"},
+  {"Pacific/Auckland", "NZST-12NZDT,M9.5.0,M4.1.0/3"},
+  {"America/St_Johns", "NST3:30NDT,M3.2.0,M11.1.0"},
+  {"America/Halifax", "AST4ADT,M3.2.0,M11.1.0"},
+  {"America/Martinique", "AST4"},
+  {"America/Sao_Paulo", "<-03>3"},
+  {"America/New_York", "EST5EDT,M3.2.0,M11.1.0"},
+  {"America/Toronto", "EST5EDT,M3.2.0,M11.1.0"},
+  {"America/Chicago", "CST6CDT,M3.2.0,M11.1.0"},
+  {"America/Mexico_City", "CST6"},
+  {"America/Denver", "MST7MDT,M3.2.0,M11.1.0"},
+  {"America/Phoenix", "MST7"},
+  {"America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0"},
+  {"America/Anchorage", "AKST9AKDT,M3.2.0,M11.1.0"},
+  {"Pacific/Honolulu", "HST10"}
+};
+const int tz_zone_count = sizeof(tz_zones) / sizeof(tz_zones[0]);
+
+// Date of a transition: Mm.w.d, Jn or n
+typedef struct tz_date
+{
+  char type;      // 'M', 'J' or 'D' (zero based day)
+  int16_t month;
+  int16_t week;
+  int16_t day;
+  int32_t time;   // seconds after local midnight
+} t_tz_date;
+
+typedef struct tz_rule
+{
+  int32_t std_offset;   // seconds, local = utc + offset
+  int32_t dst_offset;
+  bool has_dst;
+  t_tz_date start;
+  t_tz_date end;
+} t_tz_rule;
+
+typedef struct tz_transition
+{
+  int64_t utc;
+  int32_t offset;   // offset in effect from utc on
+} t_tz_transition;
+
+char _tz_string[48] = "UTC0";
+t_tz_rule _tz_rule = {0, 0, false};
+
+// Interval of the last lookup, transitions are only computed when it is left
+int64_t _tz_cache_from = 0;
+int64_t _tz_cache_until = 0;
+int32_t _tz_cache_offset = 0;
+
+// Days since 1970-01-01 of a civil date
+static int64_t days_from_civil(int y, int m, int d)
+{
+  y -= m <= 2;
+  int era = (y >= 0 ? y : y - 399) / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return (int64_t)era * 146097 + doe - 719468;
+}
+
+// Year of a day since 1970-01-01
+static int year_from_days(int64_t days)
+{
+  int y = (int)(days * 400 / 146097) + 1970;
+  while (days_from_civil(y, 1, 1) > days)
+    y--;
+  while (days_from_civil(y + 1, 1, 1) <= days)
+    y++;
+  return y;
+}
+
+static bool is_leap(int y)
+{
+  return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int month_days(int y, int m)
+{
+  static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return m == 2 && is_leap(y) ? 29 : days[m - 1];
+}
+
+// Local seconds since 1970 of a transition date in year y
+static int64_t date_to_local(const t_tz_date &date, int y)
+{
+  int64_t days;
+  if (date.type == 'M')
+  {
+    int64_t first = days_from_civil(y, date.month, 1);
+    int first_wday = (int)((first + 4) % 7);   // 1970-01-01 was a Thursday
+    int mday = 1 + (date.day - first_wday + 7) % 7 + (date.week - 1) * 7;
+    while (mday > month_days(y, date.month))
+      mday -= 7;
+    days = first + mday - 1;
+  }
+  else if (date.type == 'J')
+  {
+    // 1..365, February 29th is never counted
+    days = days_from_civil(y, 1, 1) + date.day - 1;
+    if (is_leap(y) && date.day >= 60)
+      days++;
+  }
+  else
+    days = days_from_civil(y, 1, 1) + date.day;
+  return days * 86400 + date.time;
+}
+
+static bool parse_number(const char *&p, int &value)
+{
+  if (*p < '0' || *p > '9')
+    return false;
+  value = 0;
+  while (*p >= '0' && *p <= '9')
+    value = value * 10 + (*p++ - '0');
+  return true;
+}
+
+// [+|-]hh[:mm[:ss]] in seconds
+static bool parse_time(const char *&p, int32_t &seconds)
+{
+  int sign = 1;
+  if (*p == '+' || *p == '-')
+    sign = *p++ == '-' ? -1 : 1;
+  int h, m = 0, s = 0;
+  if (!parse_number(p, h))
+    return false;
+  if (*p == ':')
+  {
+    p++;
+    if (!parse_number(p, m))
+      return false;
+    if (*p == ':')
+    {
+      p++;
+      if (!parse_number(p, s))
+        return false;
+    }
+  }
+  seconds = sign * (h * 3600 + m * 60 + s);
+  return true;
+}
+
+static bool parse_name(const char *&p)
+{
+  const char *start = p;
+  if (*p == '<')
+  {
+    while (*p && *p != '>')
+      p++;
+    if (*p != '>')
+      return false;
+    p++;
+    return p - start > 2;
+  }
+  while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))
+    p++;
+  return p - start >= 3;
+}
+
+static bool parse_date(const char *&p, t_tz_date &date)
+{
+  int a, b, c;
+  date.time = 2 * 3600;
+  if (*p == 'M')
+  {
+    p++;
+    if (!parse_number(p, a) || *p++ != '.' || !parse_number(p, b) || *p++ != '.' || !parse_number(p, c))
+      return false;
+    if (a < 1 || a > 12 || b < 1 || b > 5 || c > 6)
+      return false;
+    date = {'M', (int16_t)a, (int16_t)b, (int16_t)c, date.time};
+  }
+  else if (*p == 'J')
+  {
+    p++;
+    if (!parse_number(p, a) || a < 1 || a > 365)
+      return false;
+    date = {'J', 0, 0, (int16_t)a, date.time};
+  }
+  else
+  {
+    if (!parse_number(p, a) || a > 365)
+      return false;
+    date = {'D', 0, 0, (int16_t)a, date.time};
+  }
+  if (*p == '/')
+  {
+    p++;
+    return parse_time(p, date.time);
+  }
+  return true;
+}
+
+static bool parse_rule(const char *p, t_tz_rule &rule)
+{
+  int32_t offset;
+  if (!parse_name(p) || !parse_time(p, offset))
+    return false;
+  // POSIX offsets are west of Greenwich
+  rule.std_offset = -offset;
+  rule.dst_offset = rule.std_offset;
+  rule.has_dst = false;
+  if (*p == '\0')
+    return true;
+
+  if (!parse_name(p))
+    return false;
+  rule.has_dst = true;
+  rule.dst_offset = rule.std_offset + 3600;
+  if (*p != ',' && *p != '\0')
+  {
+    if (!parse_time(p, offset))
+      return false;
+    rule.dst_offset = -offset;
+  }
+  if (*p == '\0')
+  {
+    // No rule given, use the US one as POSIX suggests
+    rule.start = {'M', 3, 2, 0, 2 * 3600};
+    rule.end = {'M', 11, 1, 0, 2 * 3600};
+    return true;
+  }
+  if (*p++ != ',' || !parse_date(p, rule.start) || *p++ != ',' || !parse_date(p, rule.end))
+    return false;
+  return *p == '\0';
+}
+
+// The two transitions of year y, in order
+static void year_transitions(int y, t_tz_transition *transitions)
+{
+  // Start is given in standard time, end in daylight saving time
+  t_tz_transition start = {date_to_local(_tz_rule.start, y) - _tz_rule.std_offset, _tz_rule.dst_offset};
+  t_tz_transition end = {date_to_local(_tz_rule.end, y) - _tz_rule.dst_offset, _tz_rule.std_offset};
+  bool start_first = start.utc < end.utc;
+  transitions[0] = start_first ? start : end;
+  transitions[1] = start_first ? end : start;
+}
+
+bool tz_set(const char *rule)
+{
+  for (int i = 0; i < tz_zone_count; i++)
+  {
+    if (strcmp(rule, tz_zones[i].name) == 0)
+    {
+      rule = tz_zones[i].rule;
+      break;
+    }
+  }
+  t_tz_rule parsed;
+  if (strlen(rule) >= sizeof(_tz_string) || !parse_rule(rule, parsed))
+    return false;
+  strncpy(_tz_string, rule, sizeof(_tz_string) - 1);
+  _tz_rule = parsed;
+  _tz_cache_from = 0;
+  _tz_cache_until = 0;
+  return true;
+}
+
+void tz_set_fixed(int minutes)
+{
+  // POSIX sign is inverted: UTC+1 is "<+01>-1", UTC+5:30 is "<+0530>-5:30"
+  char rule[32];
+  int h = abs(minutes) / 60, m = abs(minutes) % 60;
+  const char *sign = minutes < 0 ? "" : "-";
+  if (m == 0)
+    snprintf(rule, sizeof(rule), "<%c%02d>%s%d", minutes < 0 ? '-' : '+', h, sign, h);
+  else
+    snprintf(rule, sizeof(rule), "<%c%02d%02d>%s%d:%02d", minutes < 0 ? '-' : '+', h, m, sign, h, m);
+  tz_set(rule);
+}
+
+const char *tz_get()
+{
+  return _tz_string;
+}
+
+bool tz_has_dst()
+{
+  return _tz_rule.has_dst;
+}
+
+int32_t tz_offset_at(time_t utc)
+{
+  if (!_tz_rule.has_dst)
+    return _tz_rule.std_offset;
+  int64_t t = utc;
+  if (t >= _tz_cache_from && t < _tz_cache_until)
+    return _tz_cache_offset;
+
+  // Transitions of the years around t, the year of t alone misses the
+  // ones close to new year's eve in far zones
+  t_tz_transition transitions[6];
+  int y = year_from_days((t + _tz_rule.std_offset) / 86400);
+  for (int i = 0; i < 3; i++)
+    year_transitions(y - 1 + i, transitions + i * 2);
+
+  // Last transition at or before t
+  int last = 0;
+  while (last < 4 && transitions[last + 1].utc <= t)
+    last++;
+  _tz_cache_from = transitions[last].utc;
+  _tz_cache_until = transitions[last + 1].utc;
+  _tz_cache_offset = transitions[last].offset;
+  return _tz_cache_offset;
+}
+
+time_t tz_to_local(time_t utc)
+{
+  return utc + tz_offset_at(utc);
+}
@@ -0,0 +1,98 @@
+#include "wavefront.h"
+#include "pattern_field.h"
+
+// Position of a clock along the wave, smaller goes first
+static int get_rank(int order, int col, int row, const uint8_t *shuffle)
+{
+  int from_center = abs(2 * col - (FIELD_COLUMNS - 1));
+  switch (order)
+  {
+    case WAVE_CENTER_OUT:
+      return from_center;
+    case WAVE_EDGES_IN:
+      return FIELD_COLUMNS - from_center;
+    case WAVE_LEFT_RIGHT:
+      return col;
+    case WAVE_RIGHT_LEFT:
+      return FIELD_COLUMNS - 1 - col;
+    case WAVE_DIAGONAL:
+      return col + row;
+    case WAVE_ROWS:
+      return row;
+    case WAVE_RANDOM:
+      return shuffle[col];
+  }
+  return 0;
+}
+
+// Time of a wave from its position, both 0..1000: the steeper the curve,
+// the longer the delays
+static uint32_t ease(int easing, uint32_t x)
+{
+  switch (easing)
+  {
+    case EASE_IN:
+      return 1000 - (1000 - x) * (1000 - x) / 1000;
+    case EASE_OUT:
+      return x * x / 1000;
+    case EASE_IN_OUT:
+      if (x < 500)
+        return (1000 - (1000 - 2 * x) * (1000 - 2 * x) / 1000) / 2;
+      return 500 + (2 * x - 1000) * (2 * x - 1000) / 2000;
+  }
+  return x;
+}
+
+int plan_wave(int order, int easing, uint32_t duration, t_wave_step steps[WAVE_MAX_STEPS])
+{
+  uint8_t shuffle[FIELD_COLUMNS];
+  for (int i = 0; i < FIELD_COLUMNS; i++)
+    shuffle[i] = i;
+  if (order == WAVE_RANDOM)
+  {
+    for (int i = FIELD_COLUMNS - 1; i > 0; i--)
+    {
+      int j = random(i + 1);
+      uint8_t swap = shuffle[i];
+      shuffle[i] = shuffle[j];
+      shuffle[j] = swap;
+    }
+  }
+
+  int first = get_rank(order, 0, 0, shuffle);
+  int last = first;
+  for (int col = 0; col < FIELD_COLUMNS; col++)
+    for (int row = 0; row < FIELD_ROWS; row++)
+    {
+      int rank = get_rank(order, col, row, shuffle);
+      first = min(first, rank);
+      last = max(last, rank);
+    }
+
+  int count = 0;
+  for (int col = 0; col < FIELD_COLUMNS; col++)
+    for (int row = 0; row < FIELD_ROWS; row++)
+    {
+      int rank = get_rank(order, col, row, shuffle);
+      uint32_t x = last > first ? (uint32_t)(rank - first) * 1000 / (last - first) : 0;
+      uint32_t at = (uint64_t)duration * ease(easing, x) / 1000;
+      // Clocks of a board moving together share a frame
+      int i = 0;
+      while (i < count && !(steps[i].board == col && steps[i].at == at))
+        i++;
+      if (i == count)
+        steps[count++] = {at, (uint8_t)col, 0};
+      steps[i].clocks |= 1 << row;
+    }
+
+  // Insertion sort, stable: boards keep their order within a wave
+  for (int i = 1; i < count; i++)
+  {
+    t_wave_step step = steps[i];
+    int j = i;
+    for (; j > 0 && steps[j - 1].at > step.at; j--)
+      steps[j] = steps[j - 1];
+    steps[j] = step;
+  }
+  return count;
+}
@@ -2,11 +2,14 @@
 #include <Wire.h>
 #include "i2c.h"
 #include "digit.h"
+#include "timezone.h"
+#include "time_base.h"
 
 WebServer _server(80);
 
-t_browser_time _browser_time = {0, 0, 0, 0, 0, 0};
+int64_t _browser_time = 0;
 bool _time_changed_browser = false;
+bool _ap_fallback = false;
 
 // Test state tracking
 static int _motor_positions[8][3][2]; // [board][clock][hand] = angle
@@ -15,12 +18,17 @@ static uint32_t _test_counter = 1;
 static int _test_speed = 1000;
 static int _test_accel = 500;
 
-// Initialize positions to 270 (6h00)
+// Initialize positions from the last known clock state
 void init_test_positions() {
   for(int b = 0; b < 8; b++)
+  {
+    t_half_digit hd = get_last_half_digit(b);
     for(int c = 0; c < 3; c++)
-      for(int h = 0; h < 2; h++)
-        _motor_positions[b][c][h] = 270;
+    {
+      _motor_positions[b][c][0] = hd.clocks[c].angle_h;
+      _motor_positions[b][c][1] = hd.clocks[c].angle_m;
+    }
+  }
   _drivers_enabled = true;
 }
 
@@ -47,6 +55,8 @@ void server_start()
   _server.on("/api/drivers/enable", HTTP_POST, handle_api_drivers_enable);
   _server.on("/api/drivers/disable", HTTP_POST, handle_api_drivers_disable);
   _server.on("/api/stop", HTTP_POST, handle_api_stop);
+  _server.on("/api/home", HTTP_POST, handle_api_home);
+  _server.on("/api/home", HTTP_GET, handle_api_home_status);
   _server.on("/api/settings", HTTP_POST, handle_api_settings);
   _server.on("/api/motor/position", HTTP_POST, handle_api_motor_position);
   Serial.println("WebServer setup done");
@@ -93,8 +103,9 @@ void handle_get_config()
       "\"wireless_mode\":%d,"
       "\"ssid\":\"%s\","
       "\"password\":\"%s\","
+      "\"timezone\":\"%s\","
       "\"sleep_time\":%s}",
-      get_clock_mode(), get_connection_mode(), get_ssid(), get_password(), s_time);
+      get_clock_mode(), _ap_fallback ? HOTSPOT : get_connection_mode(), get_ssid(), get_password(), tz_get(), s_time);
   }
   _server.send(200, "application/json", payload);
 }
@@ -102,27 +113,23 @@ void handle_get_config()
 void handle_post_time()
 {
   Serial.println("Handle POST /time");
-  if (_server.hasArg("h"))
-    _browser_time.hour = _server.arg("h").toInt();
-  if (_server.hasArg("m"))
-    _browser_time.minute = _server.arg("m").toInt();
-  if (_server.hasArg("s"))
-    _browser_time.second = _server.arg("s").toInt();
-  if (_server.hasArg("D"))
-    _browser_time.day = _server.arg("D").toInt();
-  if (_server.hasArg("M"))
-    _browser_time.month = _server.arg("M").toInt();
-  if (_server.hasArg("Y"))
-    _browser_time.year = _server.arg("Y").toInt();
-  if (_server.hasArg("timezone"))
+  if (!_server.hasArg("utc"))
   {
-    int _browser_timezone = _server.arg("timezone").toInt();
-    set_timezone(_browser_timezone);
+    _server.send(400, "text/plain", "");
+    return;
+  }
+  _browser_time = strtoll(_server.arg("utc").c_str(), NULL, 10);
+  if (_server.hasArg("tz") && tz_set(_server.arg("tz").c_str()))
+    set_timezone_rule(_server.arg("tz").c_str());
+  else if (_server.hasArg("offset"))
+  {
+    // Unknown zone name, only the current UTC offset is known
+    tz_set_fixed(_server.arg("offset").toInt());
+    set_timezone_rule(tz_get());
   }
   _time_changed_browser = true;
   _server.send(200, "text/plain", "");
-  Serial.printf("Time received: %d:%d:%d\n", 
-    _browser_time.hour, _browser_time.minute, _browser_time.second);
+  Serial.printf("Time received: %lld ms UTC, zone %s\n", _browser_time, tz_get());
 }
 
 void handle_post_adjust()
@@ -166,7 +173,6 @@ void handle_post_sleep()
       if (_server.hasArg(arg))
         set_sleep_time(day, i, _server.arg(arg).toInt() == 0 ? false : true);
     }
-    save_sleep_time();
   }
   _server.send(200, "text/html", "");
 }
@@ -192,7 +198,12 @@ bool is_time_changed_browser()
   return tmp;
 }
 
-t_browser_time get_browser_time()
+void set_ap_fallback(bool active)
+{
+  _ap_fallback = active;
+}
+
+int64_t get_browser_time()
 {
   return _browser_time;
 }
@@ -286,6 +297,14 @@ const char TEST_PAGE[] PROGMEM = R"rawliteral(
     <div class="title">Drivers</div>
     <button class="btn" onclick="enableDrivers()">Enable All</button>
     <button class="btn danger" onclick="disableDrivers()">Disable All</button>
+    <div style="margin-top:10px;">
+      <label>Idle timeout (s, 0 = never): <input type="number" id="idleTimeout" min="0" max="3600" value="10" style="width:70px;"></label>
+      <button class="btn" onclick="applyIdleTimeout()">Set</button>
+    </div>
+    <div style="margin-top:10px;">
+      <label>Power budget (mA, 0 = off): <input type="number" id="powerBudget" min="0" max="50000" value="0" style="width:70px;"></label>
+      <button class="btn" onclick="applyPowerBudget()">Set</button>
+    </div>
   </div>
 
   <div class="section">
@@ -293,6 +312,12 @@ const char TEST_PAGE[] PROGMEM = R"rawliteral(
     <button class="btn" onclick="moveToStop()">All to 6h00</button>
   </div>
 
+  <div class="section">
+    <div class="title">Homing</div>
+    <button class="btn" onclick="homeAll()">Home All</button>
+    <button class="btn" onclick="homeStatus()">Homing Result</button>
+  </div>
+
   <div class="section">
     <div class="title">Move to Position (Clock Convention)</div>
     <div class="inline">
@@ -402,6 +427,36 @@ const char TEST_PAGE[] PROGMEM = R"rawliteral(
       }
     }
 
+    async function applyIdleTimeout() {
+      const timeout = document.getElementById('idleTimeout').value;
+      try {
+        const res = await fetch('/api/settings', {
+          method: 'POST',
+          headers: {'Content-Type': 'application/x-www-form-urlencoded'},
+          body: 'idle_timeout=' + timeout
+        });
+        const data = await res.json();
+        log(data.message, 'ok');
+      } catch(e) {
+        log('Settings failed: ' + e, 'err');
+      }
+    }
+
+    async function applyPowerBudget() {
+      const budget = document.getElementById('powerBudget').value;
+      try {
+        const res = await fetch('/api/settings', {
+          method: 'POST',
+          headers: {'Content-Type': 'application/x-www-form-urlencoded'},
+          body: 'power_budget=' + budget
+        });
+        const data = await res.json();
+        log(data.message, 'ok');
+      } catch(e) {
+        log('Settings failed: ' + e, 'err');
+      }
+    }
+
     async function enableDrivers() {
       log('Enabling drivers...', 'info');
       try {
@@ -424,6 +479,31 @@ const char TEST_PAGE[] PROGMEM = R"rawliteral(
       }
     }
 
+    async function homeAll() {
+      log('Homing all hands...', 'info');
+      try {
+        const res = await fetch('/api/home', {method: 'POST'});
+        const data = await res.json();
+        log(data.message, 'ok');
+      } catch(e) {
+        log('Homing failed: ' + e, 'err');
+      }
+    }
+
+    async function homeStatus() {
+      try {
+        const res = await fetch('/api/home');
+        const data = await res.json();
+        data.boards.forEach(b => {
+          if(!b.found) { log('Board ' + b.address + ': no answer', 'err'); return; }
+          log('Board ' + b.address + (b.homing ? ': homing' : ': found ' + b.homed.toString(2).padStart(6, '0')) +
+              ', offsets ' + b.offsets.join(' '), b.homing ? 'info' : 'ok');
+        });
+      } catch(e) {
+        log('Homing status failed: ' + e, 'err');
+      }
+    }
+
     async function moveToStop() {
       log('Moving all to 6h00...', 'info');
       try {
@@ -497,7 +577,72 @@ void handle_api_status()
   String json = "{\"drivers_enabled\":" + String(_drivers_enabled ? "true" : "false");
   json += ",\"speed\":" + String(_test_speed);
   json += ",\"accel\":" + String(_test_accel);
-  json += "}";
+  json += ",\"idle_timeout\":" + String(get_driver_idle_timeout());
+  json += ",\"power_budget\":" + String(get_power_budget());
+  // Highest modeled motor load of the last animation of each mode (mA)
+  json += ",\"peak_ma\":[";
+  for(int mode = 0; mode < OFF; mode++) {
+    if(mode > 0) json += ",";
+    json += String(get_mode_peak_load(mode));
+  }
+  json += "]";
+  uint32_t frames_sent, frames_skipped;
+  get_send_stats(frames_sent, frames_skipped);
+  json += ",\"frames_sent\":" + String(frames_sent);
+  json += ",\"frames_skipped\":" + String(frames_skipped);
+  json += ",\"config_writes\":" + String(get_config_write_count());
+  json += ",\"config_dirty\":" + String(is_config_dirty() ? "true" : "false");
+  json += ",\"time_sync_age\":" + String(time_base_sync_age());
+  json += ",\"time_error_ms\":" + String(time_base_error_estimate());
+  json += ",\"time_drift_ppb\":" + String(time_base_drift_ppb());
+  t_time_sample samples[TIME_HISTORY_SIZE];
+  int count = time_base_history(samples, TIME_HISTORY_SIZE);
+  // Hands interrupted by a power cut, per board (bit = 2 * clock + hand)
+  // and driver telemetry per board and motor
+  t_board_status boards[8];
+  bool found[8];
+  json += ",\"uncertain_hands\":[";
+  for(int i = 0; i < 8; i++) {
+    found[i] = read_board_status(i, boards[i]);
+    if(i > 0) json += ",";
+    json += found[i] ? String(boards[i].uncertain) : String("null");
+  }
+  json += "],\"drivers\":[";
+  for(int i = 0; i < 8; i++) {
+    if(i > 0) json += ",";
+    if(!found[i]) {
+      json += "null";
+      continue;
+    }
+    json += "{\"standby\":" + String(boards[i].flags & STATUS_DRIVERS_STANDBY ? "true" : "false");
+    json += ",\"gated\":" + String(boards[i].gated);
+    // Timed frames waiting on the board, and whether it has the bus time
+    json += ",\"synced\":" + String(boards[i].flags & STATUS_SYNCED ? "true" : "false");
+    json += ",\"queued\":" + String(boards[i].queued);
+    // Motor-seconds per power state, to estimate the energy use
+    json += ",\"power\":{\"run\":" + String(boards[i].power_seconds[0]);
+    json += ",\"hold\":" + String(boards[i].power_seconds[1]);
+    json += ",\"standby\":" + String(boards[i].power_seconds[2]);
+    json += ",\"off\":" + String(boards[i].power_seconds[3]) + "}";
+    json += ",\"motors\":[";
+    for(int m = 0; m < 6; m++) {
+      if(m > 0) json += ",";
+      json += "{\"flags\":" + String(boards[i].driver_flags[m]);
+      json += ",\"temp\":" + String(boards[i].driver_temperature[m]);
+      json += ",\"load\":" + String(boards[i].driver_load[m]);
+      json += ",\"current\":" + String(boards[i].driver_current[m]) + "}";
+    }
+    json += "]}";
+  }
+  json += "]";
+  json += ",\"time_offsets\":[";
+  for(int i = 0; i < count; i++) {
+    if(i > 0) json += ",";
+    json += "{\"age\":" + String((int32_t)((time_base_now_ms() - samples[i].epoch_ms) / 1000));
+    json += ",\"offset\":" + String(samples[i].offset);
+    json += ",\"delay\":" + String(samples[i].delay) + "}";
+  }
+  json += "]}";
   _server.send(200, "application/json", json);
 }
 
@@ -514,7 +659,17 @@ void handle_api_settings()
     if(_test_accel < 100) _test_accel = 100;
     if(_test_accel > 2000) _test_accel = 2000;
   }
-  String msg = "Speed=" + String(_test_speed) + ", Accel=" + String(_test_accel);
+  if(_server.hasArg("idle_timeout")) {
+    uint32_t timeout = constrain(_server.arg("idle_timeout").toInt(), 0L, (long)MAX_DRIVER_IDLE_TIMEOUT);
+    set_driver_idle_timeout(timeout);
+    set_all_idle_timeout(timeout);
+  }
+  if(_server.hasArg("power_budget")) {
+    set_power_budget(constrain(_server.arg("power_budget").toInt(), 0L, (long)MAX_POWER_BUDGET));
+  }
+  String msg = "Speed=" + String(_test_speed) + ", Accel=" + String(_test_accel) +
+               ", Idle timeout=" + String(get_driver_idle_timeout()) + "s" +
+               ", Power budget=" + String(get_power_budget()) + "mA";
   _server.send(200, "application/json", "{\"success\":true,\"message\":\"" + msg + "\"}");
 }
 
@@ -612,6 +767,37 @@ void handle_api_stop()
   _server.send(200, "application/json", "{\"success\":true,\"message\":\"Moving to 6h00\"}");
 }
 
+void handle_api_home()
+{
+  Serial.println("API: Home");
+  home_all_boards();
+  _server.send(200, "application/json", "{\"success\":true,\"message\":\"Homing started\"}");
+}
+
+void handle_api_home_status()
+{
+  Serial.println("API: Homing status");
+  String json = "{\"boards\":[";
+  for(int i = 0; i < 8; i++) {
+    t_board_status status;
+    if(i > 0) json += ",";
+    json += "{\"address\":" + String(i + 1);
+    if(!read_board_status(i, status)) {
+      json += ",\"found\":false}";
+      continue;
+    }
+    json += ",\"found\":true,\"homing\":" + String(status.flags & STATUS_HOMING ? "true" : "false");
+    json += ",\"homed\":" + String(status.homed) + ",\"offsets\":[";
+    for(int h = 0; h < 6; h++) {
+      if(h > 0) json += ",";
+      json += String(status.home_offset[h]);
+    }
+    json += "]}";
+  }
+  json += "]}";
+  _server.send(200, "application/json", json);
+}
+
 void handle_api_motor_position()
 {
   Serial.println("API: Motor position");
@@ -0,0 +1,44 @@
+#ifndef ARDUINO_STUB_H
+#define ARDUINO_STUB_H
+
+// Just enough of Arduino.h for the native tests of the modules that don't
+// touch the hardware, millis() and micros() are set by the tests
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+#define PROGMEM
+
+inline uint32_t _stub_millis = 0;
+inline uint32_t _stub_micros = 0;
+
+inline uint32_t millis() { return _stub_millis; }
+inline uint32_t micros() { return _stub_micros; }
+
+// Logs are dropped
+struct stub_serial
+{
+  int printf(const char *, ...) { return 0; }
+  void println(const char *) {}
+};
+inline stub_serial Serial;
+
+// Single threaded, critical sections have nothing to exclude
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+#endif
@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <stddef.h>
+#include "clock_state.h"
+#include "pose_frame.h"
+
+// The slave's copy of the shared structs, as the slave firmware builds it
+namespace slave
+{
+#include "../../../slave/include/clock_state.h"
+}
+
+// Little endian writers, the layout of tools/pose_sender.py: "<IIIHHBB48H"
+static void put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+  put_u16(p, v & 0xFFFF);
+  put_u16(p + 2, v >> 16);
+}
+
+static t_pose_frame make_frame(uint32_t sequence, uint32_t sent_ms, uint8_t flags)
+{
+  uint8_t bytes[114];
+  put_u32(bytes, UDP_POSE_MAGIC);
+  put_u32(bytes + 4, sequence);
+  put_u32(bytes + 8, sent_ms);
+  put_u16(bytes + 12, 800);
+  put_u16(bytes + 14, 400);
+  bytes[16] = MIN_DISTANCE;
+  bytes[17] = flags;
+  for (int i = 0; i < 48; i++)
+    put_u16(bytes + 18 + i * 2, i * 7);
+  t_pose_frame frame;
+  memcpy(&frame, bytes, sizeof(frame));
+  return frame;
+}
+
+void setUp(void)
+{
+  _udp_has_sequence = false;
+  _udp_has_offset = false;
+}
+
+void tearDown(void) {}
+
+void test_pose_frame_layout(void)
+{
+  TEST_ASSERT_EQUAL(114, sizeof(t_pose_frame));
+  TEST_ASSERT_EQUAL(13, sizeof(t_pose_ack));
+  t_pose_frame frame = make_frame(0x01020304, 0xA0B0C0D0, POSE_FLAG_RESET);
+  TEST_ASSERT_EQUAL_UINT32(UDP_POSE_MAGIC, frame.magic);
+  TEST_ASSERT_EQUAL_UINT32(0x01020304, frame.sequence);
+  TEST_ASSERT_EQUAL_UINT32(0xA0B0C0D0, frame.sent_ms);
+  TEST_ASSERT_EQUAL(800, frame.speed);
+  TEST_ASSERT_EQUAL(400, frame.accel);
+  TEST_ASSERT_EQUAL(MIN_DISTANCE, frame.direction);
+  TEST_ASSERT_EQUAL(POSE_FLAG_RESET, frame.flags);
+  TEST_ASSERT_EQUAL(0, frame.angles[0]);
+  TEST_ASSERT_EQUAL(47 * 7, frame.angles[47]);
+}
+
+void test_drop_rules(void)
+{
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(10, 1000, 0), 5000));
+  // Duplicate and older sequences
+  TEST_ASSERT_EQUAL(POSE_DROPPED_OLD, check_pose_frame(make_frame(10, 1050, 0), 5050));
+  TEST_ASSERT_EQUAL(POSE_DROPPED_OLD, check_pose_frame(make_frame(9, 1050, 0), 5050));
+  // 250 ms slower than the fastest frame is still on time, not one more
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(11, 1100, 0), 5350));
+  TEST_ASSERT_EQUAL(POSE_DROPPED_LATE, check_pose_frame(make_frame(12, 1200, 0), 5451));
+  // A faster frame becomes the reference
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(13, 1300, 0), 5200));
+  TEST_ASSERT_EQUAL(POSE_DROPPED_LATE, check_pose_frame(make_frame(14, 1400, 0), 5551));
+  // Restarted sender: old sequence numbers and a new clock are accepted
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(1, 90000, POSE_FLAG_RESET), 6000));
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(2, 90100, 0), 6100));
+}
+
+void test_sequence_wraps(void)
+{
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(0xFFFFFFFF, 0xFFFFFF00, 0), 100));
+  TEST_ASSERT_EQUAL(POSE_APPLIED, check_pose_frame(make_frame(0, 0xFFFFFF80, 0), 228));
+  TEST_ASSERT_EQUAL(POSE_DROPPED_OLD, check_pose_frame(make_frame(0xFFFFFFFE, 0xFFFFFF90, 0), 244));
+}
+
+// I2C frames are the raw structs (I2C_writeAnything), both sides must agree
+void test_board_frames_match_slave(void)
+{
+  TEST_ASSERT_EQUAL(60, sizeof(t_half_digit));
+  TEST_ASSERT_EQUAL(64, sizeof(t_timed_half_digit));
+  TEST_ASSERT_EQUAL(sizeof(t_clock), sizeof(slave::t_clock));
+  TEST_ASSERT_EQUAL(sizeof(t_half_digit), sizeof(slave::t_half_digit));
+  TEST_ASSERT_EQUAL(sizeof(t_timed_half_digit), sizeof(slave::t_timed_half_digit));
+  TEST_ASSERT_EQUAL(sizeof(t_board_status), sizeof(slave::t_board_status));
+  TEST_ASSERT_EQUAL(offsetof(t_clock, mode_h), offsetof(slave::t_clock, mode_h));
+  TEST_ASSERT_EQUAL(offsetof(t_clock, adjust_m), offsetof(slave::t_clock, adjust_m));
+  TEST_ASSERT_EQUAL(offsetof(t_half_digit, change_counter), offsetof(slave::t_half_digit, change_counter));
+  TEST_ASSERT_EQUAL(offsetof(t_timed_half_digit, start_us), offsetof(slave::t_timed_half_digit, start_us));
+  TEST_ASSERT_EQUAL(offsetof(t_board_status, queued), offsetof(slave::t_board_status, queued));
+  TEST_ASSERT_EQUAL(ROTATE_COUNTERCLOCKWISE, (int)slave::ROTATE_COUNTERCLOCKWISE);
+  TEST_ASSERT_EQUAL(STATUS_SYNCED, (int)slave::STATUS_SYNCED);
+}
+
+void test_timed_frame_bytes(void)
+{
+  t_timed_half_digit sent = {0};
+  for (int i = 0; i < 3; i++)
+  {
+    sent.half_digit.clocks[i] = {(uint16_t)(90 * i), 270, 600, 700, 300, 200, CLOCKWISE2, ROTATE_CLOCKWISE, -3, 4};
+    sent.half_digit.change_counter[i] = 0x11223344 + i;
+  }
+  sent.start_us = 0xCAFEF00D;
+  uint8_t bytes[sizeof(sent)];
+  memcpy(bytes, &sent, sizeof(sent));
+
+  slave::t_timed_half_digit received;
+  memcpy(&received, bytes, sizeof(received));
+  for (int i = 0; i < 3; i++)
+  {
+    TEST_ASSERT_EQUAL(90 * i, received.half_digit.clocks[i].angle_h);
+    TEST_ASSERT_EQUAL(270, received.half_digit.clocks[i].angle_m);
+    TEST_ASSERT_EQUAL(600, received.half_digit.clocks[i].speed_h);
+    TEST_ASSERT_EQUAL(200, received.half_digit.clocks[i].accel_m);
+    TEST_ASSERT_EQUAL(slave::CLOCKWISE2, received.half_digit.clocks[i].mode_h);
+    TEST_ASSERT_EQUAL(slave::ROTATE_CLOCKWISE, received.half_digit.clocks[i].mode_m);
+    TEST_ASSERT_EQUAL(-3, received.half_digit.clocks[i].adjust_h);
+    TEST_ASSERT_EQUAL_UINT32(0x11223344 + i, received.half_digit.change_counter[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0xCAFEF00D, received.start_us);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pose_frame_layout);
+  RUN_TEST(test_drop_rules);
+  RUN_TEST(test_sequence_wraps);
+  RUN_TEST(test_board_frames_match_slave);
+  RUN_TEST(test_timed_frame_bytes);
+  return UNITY_END();
+}
@@ -0,0 +1,118 @@
+#include <unity.h>
+#include "ntp_packet.h"
+
+// 2026-10-19 12:00:00.250 UTC
+#define T_2026 1792411200250LL
+
+// Server answer to a request: receive time t2, transmit time t3
+static void make_response(uint8_t *packet, const uint8_t *request, int64_t t2, int64_t t3, uint8_t stratum)
+{
+  memset(packet, 0, NTP_PACKET_SIZE);
+  packet[0] = 0x24;
+  packet[1] = stratum;
+  memcpy(packet + 24, request + 40, 8);
+  ntp_from_unix_ms(t2, packet + 32);
+  ntp_from_unix_ms(t3, packet + 40);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_timestamp_round_trip(void)
+{
+  const int64_t times[] = {0, 1, 999, 1000, T_2026, T_2026 + 749};
+  for (int64_t t : times)
+  {
+    uint8_t timestamp[8];
+    ntp_from_unix_ms(t, timestamp);
+    TEST_ASSERT_INT_WITHIN(1, t, ntp_to_unix_ms(timestamp));
+  }
+  // 1 January 1970 in the NTP era
+  uint8_t epoch[8] = {0x83, 0xAA, 0x7E, 0x80, 0x80, 0, 0, 0};
+  TEST_ASSERT_EQUAL_INT64(500, ntp_to_unix_ms(epoch));
+}
+
+void test_request(void)
+{
+  uint8_t request[NTP_PACKET_SIZE];
+  ntp_build_request(request, T_2026);
+  TEST_ASSERT_EQUAL(0xE3, request[0]);
+  TEST_ASSERT_INT_WITHIN(1, T_2026, ntp_to_unix_ms(request + 40));
+}
+
+void test_symmetric_path(void)
+{
+  uint8_t request[NTP_PACKET_SIZE], response[NTP_PACKET_SIZE];
+  int64_t t1 = T_2026;
+  ntp_build_request(request, t1);
+  // Server 350 ms ahead, 20 ms each way, 3 ms to answer
+  make_response(response, request, t1 + 350 + 20, t1 + 350 + 23, 2);
+  t_ntp_sample sample = ntp_parse_response(response, request, t1, t1 + 43);
+  TEST_ASSERT_TRUE(sample.valid);
+  TEST_ASSERT_INT_WITHIN(1, 350, sample.offset);
+  TEST_ASSERT_INT_WITHIN(1, 40, sample.delay);
+}
+
+void test_asymmetric_path(void)
+{
+  uint8_t request[NTP_PACKET_SIZE], response[NTP_PACKET_SIZE];
+  int64_t t1 = T_2026 + 123;
+  ntp_build_request(request, t1);
+  // Server 80 ms behind, 5 ms out and 45 ms back: the offset is off by half the difference
+  make_response(response, request, t1 - 80 + 5, t1 - 80 + 5, 1);
+  t_ntp_sample sample = ntp_parse_response(response, request, t1, t1 + 50);
+  TEST_ASSERT_TRUE(sample.valid);
+  TEST_ASSERT_INT_WITHIN(1, -80 - 20, sample.offset);
+  TEST_ASSERT_INT_WITHIN(1, 50, sample.delay);
+  // The true offset is within the delay / 2 bound
+  TEST_ASSERT_LESS_OR_EQUAL(sample.delay / 2, llabs(sample.offset + 80));
+}
+
+void test_unset_clock(void)
+{
+  // Before the first sync the time base reads 0
+  uint8_t request[NTP_PACKET_SIZE], response[NTP_PACKET_SIZE];
+  ntp_build_request(request, 0);
+  make_response(response, request, T_2026, T_2026 + 1, 2);
+  t_ntp_sample sample = ntp_parse_response(response, request, 0, 30);
+  TEST_ASSERT_TRUE(sample.valid);
+  TEST_ASSERT_INT_WITHIN(1, T_2026 - 15, sample.offset);
+}
+
+void test_rejected_answers(void)
+{
+  uint8_t request[NTP_PACKET_SIZE], response[NTP_PACKET_SIZE];
+  ntp_build_request(request, T_2026);
+  // Kiss-o'-death
+  make_response(response, request, T_2026, T_2026, 0);
+  TEST_ASSERT_FALSE(ntp_parse_response(response, request, T_2026, T_2026 + 10).valid);
+  // Answer to an older request
+  make_response(response, request, T_2026, T_2026, 2);
+  response[31] ^= 1;
+  TEST_ASSERT_FALSE(ntp_parse_response(response, request, T_2026, T_2026 + 10).valid);
+}
+
+void test_negative_delay(void)
+{
+  // Server timestamps wider than the round trip (bad server clock)
+  uint8_t request[NTP_PACKET_SIZE], response[NTP_PACKET_SIZE];
+  ntp_build_request(request, T_2026);
+  make_response(response, request, T_2026, T_2026 + 100, 2);
+  t_ntp_sample sample = ntp_parse_response(response, request, T_2026, T_2026 + 10);
+  TEST_ASSERT_TRUE(sample.valid);
+  TEST_ASSERT_EQUAL_INT64(0, sample.delay);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_timestamp_round_trip);
+  RUN_TEST(test_request);
+  RUN_TEST(test_symmetric_path);
+  RUN_TEST(test_asymmetric_path);
+  RUN_TEST(test_unset_clock);
+  RUN_TEST(test_rejected_answers);
+  RUN_TEST(test_negative_delay);
+  return UNITY_END();
+}
@@ -0,0 +1,101 @@
+#include <unity.h>
+#include "pattern_field.h"
+
+static int32_t reference(double value)
+{
+  return (int32_t)lround(value * FIELD_ONE);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_angle_wraps(void)
+{
+  TEST_ASSERT_EQUAL(0, field_angle(0));
+  TEST_ASSERT_EQUAL(359, field_angle(-1));
+  TEST_ASSERT_EQUAL(0, field_angle(360));
+  TEST_ASSERT_EQUAL(5, field_angle(725));
+  TEST_ASSERT_EQUAL(355, field_angle(-725));
+}
+
+// Within one unit of the rounded sine, on every degree and any turn
+void test_sin_cos_accuracy(void)
+{
+  for (int a = -720; a <= 720; a++)
+  {
+    double rad = a * M_PI / 180;
+    TEST_ASSERT_INT_WITHIN(1, reference(sin(rad)), field_sin(a));
+    TEST_ASSERT_INT_WITHIN(1, reference(cos(rad)), field_cos(a));
+  }
+  TEST_ASSERT_EQUAL(0, field_sin(0));
+  TEST_ASSERT_EQUAL(FIELD_ONE, field_sin(90));
+  TEST_ASSERT_EQUAL(0, field_sin(180));
+  TEST_ASSERT_EQUAL(-FIELD_ONE, field_sin(270));
+  TEST_ASSERT_EQUAL(FIELD_ONE, field_cos(0));
+  TEST_ASSERT_EQUAL(-FIELD_ONE, field_cos(180));
+}
+
+void test_phase(void)
+{
+  TEST_ASSERT_EQUAL(0, field_phase(0, 4000));
+  TEST_ASSERT_EQUAL(90, field_phase(1000, 4000));
+  TEST_ASSERT_EQUAL(359, field_phase(3999, 4000));
+  TEST_ASSERT_EQUAL(0, field_phase(4000, 4000));
+  TEST_ASSERT_EQUAL(180, field_phase(6000, 4000));
+}
+
+void test_wave(void)
+{
+  const uint32_t period = 8000;
+  const int wavelength = 8;
+  for (uint32_t t = 0; t < period; t += 250)
+  {
+    for (int position = 0; position < 8; position++)
+    {
+      int32_t value = field_wave(position, t, period, wavelength, 45);
+      TEST_ASSERT_TRUE(value >= -45 && value <= 45);
+      // The wave moves one clock towards increasing positions every period / wavelength
+      TEST_ASSERT_EQUAL(value, field_wave(position + 1, t + period / wavelength, period, wavelength, 45));
+    }
+  }
+  TEST_ASSERT_EQUAL(45, field_wave(0, period / 4, period, wavelength, 45));
+  TEST_ASSERT_EQUAL(-45, field_wave(0, 3 * period / 4, period, wavelength, 45));
+}
+
+void test_noise(void)
+{
+  const uint32_t period = 1000;
+  for (int col = 0; col < FIELD_COLUMNS; col++)
+  {
+    for (int row = 0; row < FIELD_ROWS; row++)
+    {
+      int32_t last = field_noise(col, row, 0, period);
+      for (uint32_t t = 10; t < 10 * period; t += 10)
+      {
+        int32_t value = field_noise(col, row, t, period);
+        TEST_ASSERT_TRUE(value >= -FIELD_ONE && value <= FIELD_ONE);
+        // No jump, including across two slots: the steepest part of the
+        // cosine easing over the whole range moves about 32 per 1/100 of a
+        // period, the whole degrees of the easing angle add a little
+        TEST_ASSERT_TRUE(abs(value - last) <= 50);
+        last = value;
+      }
+      // Same clock and time, same value
+      TEST_ASSERT_EQUAL(field_noise(col, row, 1234, period), field_noise(col, row, 1234, period));
+    }
+  }
+  TEST_ASSERT_TRUE(field_noise(0, 0, 0, period) != field_noise(1, 0, 0, period) ||
+                   field_noise(0, 1, 0, period) != field_noise(0, 2, 0, period));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_angle_wraps);
+  RUN_TEST(test_sin_cos_accuracy);
+  RUN_TEST(test_phase);
+  RUN_TEST(test_wave);
+  RUN_TEST(test_noise);
+  return UNITY_END();
+}
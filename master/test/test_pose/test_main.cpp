@@ -0,0 +1,60 @@
+#include <unity.h>
+#include "pose.h"
+#include "digit.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Board by board, top clock first, hour hand first
+void test_layout(void)
+{
+  t_full_clock clock = make_clock(digit_0, digit_1, digit_2, digit_3);
+  t_pose pose = pose_from_clock(clock);
+  for (int col = 0; col < POSE_COLUMNS; col++)
+  {
+    const t_half_digitl &expected = get_column(clock, col);
+    t_half_digitl column = pose_column(pose, col);
+    for (int row = 0; row < POSE_ROWS; row++)
+    {
+      TEST_ASSERT_EQUAL(expected.clocks[row].angle_h, pose.angle[(col * 3 + row) * 2]);
+      TEST_ASSERT_EQUAL(expected.clocks[row].angle_m, pose.angle[(col * 3 + row) * 2 + 1]);
+      TEST_ASSERT_EQUAL(expected.clocks[row].angle_h, column.clocks[row].angle_h);
+      TEST_ASSERT_EQUAL(expected.clocks[row].angle_m, column.clocks[row].angle_m);
+    }
+  }
+}
+
+void test_set_clock(void)
+{
+  t_pose pose = pose_from_clock(d_stop);
+  pose_set_clock(pose, 5, 2, {45, 135});
+  TEST_ASSERT_EQUAL(45, pose.angle[pose_index(5, 2, HAND_H)]);
+  TEST_ASSERT_EQUAL(135, pose.angle[pose_index(5, 2, HAND_M)]);
+  TEST_ASSERT_EQUAL(45, pose_column(pose, 5).clocks[2].angle_h);
+  TEST_ASSERT_EQUAL(270, pose_column(pose, 5).clocks[1].angle_h);
+  TEST_ASSERT_EQUAL(270, pose_column(pose, 4).clocks[2].angle_m);
+}
+
+void test_diff(void)
+{
+  t_pose a = pose_from_clock(d_stop);
+  t_pose b = a;
+  TEST_ASSERT_EQUAL(0, pose_diff(a, b));
+  pose_set_clock(b, 1, 0, {90, 270});
+  pose_set_clock(b, 7, 2, {0, 270});
+  TEST_ASSERT_EQUAL_UINT32(1UL << 3 | 1UL << 23, pose_diff(a, b));
+  // Swapped hands show the same picture
+  pose_set_clock(a, 2, 1, {90, 180});
+  pose_set_clock(b, 2, 1, {180, 90});
+  TEST_ASSERT_EQUAL_UINT32(1UL << 3 | 1UL << 23, pose_diff(a, b));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_layout);
+  RUN_TEST(test_set_clock);
+  RUN_TEST(test_diff);
+  return UNITY_END();
+}
@@ -0,0 +1,89 @@
+#include <unity.h>
+#include "time_base.h"
+
+// 2024-07-01 00:00 UTC
+#define EPOCH_MS 1719792000000LL
+
+// Local oscillator 30 ppm slow: millis() lags the real time
+#define SIM_DRIFT_PPM 30
+// NTP samples are off by up to this (ms)
+#define SIM_NOISE 15
+
+static uint64_t _real_ms = 0;
+static uint32_t _seed = 1;
+
+static void run_to(uint64_t real_ms)
+{
+  _real_ms = real_ms;
+  _stub_millis = (uint32_t)(real_ms - real_ms * SIM_DRIFT_PPM / 1000000);
+}
+
+static int32_t noise()
+{
+  _seed = _seed * 1103515245 + 12345;
+  return (int32_t)((_seed >> 16) % (2 * SIM_NOISE + 1)) - SIM_NOISE;
+}
+
+// Real time minus clock time (ms)
+static int64_t clock_error()
+{
+  return EPOCH_MS + (int64_t)_real_ms - time_base_now_ms();
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_step_and_slew(void)
+{
+  _stub_millis = 0;
+  time_base_set(EPOCH_MS);
+  TEST_ASSERT_TRUE(time_base_is_set());
+  // Small corrections are slewed, 1 ms every TIME_SLEW_RATIO ms
+  time_base_adjust(100);
+  TEST_ASSERT_EQUAL(100, time_base_pending_slew());
+  _stub_millis = 1000;
+  TEST_ASSERT_EQUAL(EPOCH_MS + 1000 + 1000 / TIME_SLEW_RATIO, time_base_now_ms());
+  _stub_millis = 10000;
+  TEST_ASSERT_EQUAL(0, time_base_pending_slew());
+  TEST_ASSERT_EQUAL(EPOCH_MS + 10100, time_base_now_ms());
+  // Big ones are stepped
+  time_base_adjust(-1000);
+  TEST_ASSERT_EQUAL(0, time_base_pending_slew());
+  TEST_ASSERT_EQUAL(EPOCH_MS + 9100, time_base_now_ms());
+}
+
+// A day of NTP rounds, then 3 days without network: the drift estimate
+// keeps the clock within 0.4 s instead of the 7.8 s of a raw 30 ppm crystal
+void test_drift_compensation(void)
+{
+  const uint64_t hour = 60 * 60 * 1000ULL;
+  const uint64_t poll = 30 * 60 * 1000ULL;
+  run_to(0);
+  time_base_set(EPOCH_MS);
+  for (uint64_t t = poll; t <= 24 * hour; t += poll)
+  {
+    run_to(t);
+    time_base_rebase();
+    int32_t delay = 20 + noise();
+    time_base_sync(clock_error() + noise(), delay);
+  }
+  TEST_ASSERT_INT_WITHIN(1500, SIM_DRIFT_PPM * 1000, time_base_drift_ppb());
+
+  for (uint64_t t = 25 * hour; t <= 4 * 24 * hour; t += hour)
+  {
+    run_to(t);
+    time_base_rebase();
+  }
+  TEST_ASSERT_INT_WITHIN(400, 0, clock_error());
+  // The estimate covers the real error
+  TEST_ASSERT_TRUE(time_base_error_estimate() >= abs((int)clock_error()));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_step_and_slew);
+  RUN_TEST(test_drift_compensation);
+  return UNITY_END();
+}
@@ -0,0 +1,78 @@
+#include <unity.h>
+#include "timezone.h"
+
+void setUp(void)
+{
+  tz_set("UTC0");
+}
+
+void tearDown(void) {}
+
+void test_fixed_offsets(void)
+{
+  tz_set_fixed(60);
+  TEST_ASSERT_EQUAL_STRING("<+01>-1", tz_get());
+  TEST_ASSERT_EQUAL(3600, tz_offset_at(1719792000));
+  // Half hour zones are kept to the minute
+  tz_set_fixed(330);
+  TEST_ASSERT_EQUAL_STRING("<+0530>-5:30", tz_get());
+  TEST_ASSERT_EQUAL(19800, tz_offset_at(1719792000));
+  tz_set_fixed(-210);
+  TEST_ASSERT_EQUAL_STRING("<-0330>3:30", tz_get());
+  TEST_ASSERT_EQUAL(-12600, tz_offset_at(1719792000));
+  TEST_ASSERT_FALSE(tz_has_dst());
+  // The rule is a valid POSIX string, as stored in the config
+  TEST_ASSERT_TRUE(tz_set("<+0530>-5:30"));
+  TEST_ASSERT_EQUAL(19800, tz_offset_at(1719792000));
+}
+
+void test_zone_names(void)
+{
+  TEST_ASSERT_TRUE(tz_set("Asia/Kolkata"));
+  TEST_ASSERT_EQUAL(19800, tz_offset_at(1719792000));
+  TEST_ASSERT_TRUE(tz_set("America/St_Johns"));
+  TEST_ASSERT_EQUAL(-12600, tz_offset_at(1705276800));
+  TEST_ASSERT_EQUAL(-9000, tz_offset_at(1719792000));
+  // Unknown names keep the previous rule
+  TEST_ASSERT_FALSE(tz_set("Mars/Olympus_Mons"));
+  TEST_ASSERT_EQUAL_STRING("NST3:30NDT,M3.2.0,M11.1.0", tz_get());
+}
+
+void test_transitions(void)
+{
+  TEST_ASSERT_TRUE(tz_set("Europe/Paris"));
+  TEST_ASSERT_TRUE(tz_has_dst());
+  // 2024-03-31 and 2024-10-27, 01:00 UTC
+  TEST_ASSERT_EQUAL(3600, tz_offset_at(1711846800 - 1));
+  TEST_ASSERT_EQUAL(7200, tz_offset_at(1711846800));
+  TEST_ASSERT_EQUAL(7200, tz_offset_at(1729990800 - 1));
+  TEST_ASSERT_EQUAL(3600, tz_offset_at(1729990800));
+  // Back in time, past the cached interval
+  TEST_ASSERT_EQUAL(7200, tz_offset_at(1719792000));
+  TEST_ASSERT_EQUAL(3600, tz_offset_at(1705276800));
+  // Any year
+  TEST_ASSERT_EQUAL(7200, tz_offset_at(646790400));
+  TEST_ASSERT_EQUAL(3600, tz_offset_at(3788121600LL));
+  TEST_ASSERT_EQUAL(7200, tz_offset_at(3802550400LL));
+}
+
+void test_southern_hemisphere(void)
+{
+  TEST_ASSERT_TRUE(tz_set("Australia/Sydney"));
+  // Summer time over new year's eve, ends 2025-04-06 03:00 local
+  TEST_ASSERT_EQUAL(39600, tz_offset_at(1735689600 - 1));
+  TEST_ASSERT_EQUAL(39600, tz_offset_at(1735689600));
+  TEST_ASSERT_EQUAL(39600, tz_offset_at(1743868800 - 1));
+  TEST_ASSERT_EQUAL(36000, tz_offset_at(1743868800));
+  TEST_ASSERT_EQUAL(1743868800 + 36000, tz_to_local(1743868800));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_offsets);
+  RUN_TEST(test_zone_names);
+  RUN_TEST(test_transitions);
+  RUN_TEST(test_southern_hemisphere);
+  return UNITY_END();
+}
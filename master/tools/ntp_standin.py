@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Stand-in SNTP server for bench testing the master's NTP client (include/ntp.h).
+
+Answers NTP requests with the host clock, optionally shifted by --offset and
+with an asymmetric --delay, to watch the client on a LAN: the logged offset
+should be --offset - --delay / 2. Build the master with
+-DNTP_LOCAL_SERVER=\\"<host ip>\\". The offset/delay computation itself is
+tested on the host by test/test_ntp (pio test -e native).
+
+  sudo python3 ntp_standin.py --offset 350
+"""
+
+import argparse
+import socket
+import struct
+import threading
+import time
+
+NTP_UNIX_OFFSET = 2208988800
+PACKET = struct.Struct("!BBbbII4sQQQQ")
+
+
+def to_ntp(t):
+    seconds = int(t)
+    return ((seconds + NTP_UNIX_OFFSET) << 32) | int((t - seconds) * (1 << 32))
+
+
+def serve(sock, offset_ms, delay_ms, stop):
+    while not stop.is_set():
+        try:
+            data, addr = sock.recvfrom(512)
+        except socket.timeout:
+            continue
+        if len(data) < PACKET.size:
+            continue
+        t2 = time.time() + offset_ms / 1000
+        request = PACKET.unpack(data[:PACKET.size])
+        t3 = time.time() + offset_ms / 1000
+        # Only the answer is delayed, after T3: the client sees an asymmetric path
+        time.sleep(delay_ms / 1000)
+        reply = PACKET.pack(0x24, 2, 6, -20, 0, 0, b"LOCL", to_ntp(t2), request[10], to_ntp(t2), to_ntp(t3))
+        sock.sendto(reply, addr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=123)
+    parser.add_argument("--offset", type=float, default=0.0, help="ms added to the served time")
+    parser.add_argument("--delay", type=float, default=0.0, help="ms added to the answer path")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(0.1)
+    sock.bind(("0.0.0.0", args.port))
+    print(f"Serving NTP on port {args.port}, offset {args.offset} ms, delay {args.delay} ms")
+    try:
+        serve(sock, args.offset, args.delay, threading.Event())
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
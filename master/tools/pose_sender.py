@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Reference sender for the ClockClock24 UDP pose stream (see docs/UDP_CONTROL.md).
+
+Streams sequence-numbered pose frames to the master and measures end-to-end
+latency (from the acks) and frame loss.
+
+  python3 pose_sender.py clockclock24.local --fps 20 --seconds 10
+  python3 pose_sender.py --loopback --loss 0.05 --jitter 30
+"""
+
+import argparse
+import random
+import socket
+import struct
+import threading
+import time
+
+PORT = 4210
+MAGIC = 0x34324343
+FLAG_RESET = 0x01
+MAX_FRAME_AGE = 250  # ms, must match UDP_MAX_FRAME_AGE
+
+FRAME = struct.Struct("<IIIHHBB48H")
+ACK = struct.Struct("<IIIB")
+STATUS = ["applied", "dropped_old", "dropped_late", "superseded"]
+MIN_DISTANCE = 6
+
+
+def now_ms():
+    return int(time.monotonic() * 1000) & 0xFFFFFFFF
+
+
+def spin_pose(t):
+    """All hands rotating together, minute hands 4x faster than hour hands."""
+    h = int(t * 30) % 360
+    m = int(t * 120) % 360
+    return [h, m] * 24
+
+
+def loopback_receiver(sock, loss, jitter, stop):
+    """Reference receiver implementing the same drop rules as the master.
+
+    A copy for testing senders, the firmware rules themselves are tested by
+    test/test_frames (pio test -e native).
+    """
+    last_seq = None
+    min_offset = None
+    while not stop.is_set():
+        try:
+            data, addr = sock.recvfrom(1024)
+        except socket.timeout:
+            continue
+        if len(data) != FRAME.size or random.random() < loss:
+            continue
+        if jitter:
+            time.sleep(random.uniform(0, jitter) / 1000)
+        fields = FRAME.unpack(data)
+        magic, seq, sent, flags = fields[0], fields[1], fields[2], fields[6]
+        if magic != MAGIC:
+            continue
+        if flags & FLAG_RESET:
+            last_seq, min_offset = None, None
+        if last_seq is not None and not 0 < ((seq - last_seq) & 0xFFFFFFFF) < 0x80000000:
+            status = 1
+        else:
+            offset = (now_ms() - sent) & 0xFFFFFFFF
+            if offset >= 0x80000000:
+                offset -= 0x100000000
+            min_offset = offset if min_offset is None else min(min_offset, offset)
+            last_seq = seq
+            status = 2 if offset - min_offset > MAX_FRAME_AGE else 0
+        sock.sendto(ACK.pack(MAGIC, seq, sent, status), addr)
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", nargs="?", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=PORT)
+    parser.add_argument("--fps", type=float, default=20)
+    parser.add_argument("--seconds", type=float, default=10)
+    parser.add_argument("--speed", type=int, default=800)
+    parser.add_argument("--accel", type=int, default=400)
+    parser.add_argument("--loopback", action="store_true", help="run a local reference receiver")
+    parser.add_argument("--loss", type=float, default=0.0, help="loopback: simulated loss ratio")
+    parser.add_argument("--jitter", type=float, default=0.0, help="loopback: max extra delay in ms")
+    args = parser.parse_args()
+
+    stop = threading.Event()
+    if args.loopback:
+        rx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        rx.bind(("127.0.0.1", 0))
+        rx.settimeout(0.1)
+        args.host, args.port = "127.0.0.1", rx.getsockname()[1]
+        threading.Thread(target=loopback_receiver, args=(rx, args.loss, args.jitter, stop), daemon=True).start()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(0.005)
+    target = (socket.gethostbyname(args.host), args.port)
+
+    sent = {}
+    latencies = []
+    statuses = [0] * len(STATUS)
+    period = 1.0 / args.fps
+    start = time.monotonic()
+    seq = 0
+
+    def drain():
+        while True:
+            try:
+                data, _ = sock.recvfrom(64)
+            except (socket.timeout, BlockingIOError):
+                return
+            if len(data) != ACK.size:
+                continue
+            magic, ack_seq, ack_sent, status = ACK.unpack(data)
+            if magic != MAGIC or ack_seq not in sent:
+                continue
+            del sent[ack_seq]
+            statuses[min(status, len(STATUS) - 1)] += 1
+            latencies.append(((now_ms() - ack_sent) & 0xFFFFFFFF) / 2)
+
+    while time.monotonic() - start < args.seconds:
+        t = time.monotonic() - start
+        seq += 1
+        stamp = now_ms()
+        flags = FLAG_RESET if seq == 1 else 0
+        sock.sendto(FRAME.pack(MAGIC, seq, stamp, args.speed, args.accel, MIN_DISTANCE, flags, *spin_pose(t)), target)
+        sent[seq] = stamp
+        next_frame = start + seq * period
+        while time.monotonic() < next_frame:
+            drain()
+    # Late acks
+    deadline = time.monotonic() + 1.0
+    while sent and time.monotonic() < deadline:
+        drain()
+    stop.set()
+
+    lost = len(sent)
+    print(f"frames sent:  {seq}")
+    for name, count in zip(STATUS, statuses):
+        print(f"{name + ':':13} {count}")
+    print(f"lost:         {lost} ({100.0 * lost / max(seq, 1):.1f}%)")
+    print(f"latency ms:   p50 {percentile(latencies, 0.5):.1f}  p95 {percentile(latencies, 0.95):.1f}  "
+          f"max {max(latencies, default=0):.1f}  (one way, RTT/2)")
+
+
+if __name__ == "__main__":
+    main()
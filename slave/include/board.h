@@ -4,9 +4,20 @@
 #include "clock_accel_stepper.h"
 #include "board_config.h"
 #include "clock_state.h"
+#include "tmc2209.h"
 
 #define INIT_HANDS_ANGLE 270
 
+// Power states counted by get_power_seconds()
+enum power_states
+{
+  POWER_RUN,        // stepping at IRUN
+  POWER_HOLD,       // stopped at IHOLD
+  POWER_STANDBY,    // TMC_STANDBY_CURRENT, after an idle timeout or a disable
+  POWER_OFF,        // TMC_ENN released
+  POWER_STATES
+};
+
 /**
  * Initializes all motor objects and get the I2C address
 */
@@ -31,7 +42,90 @@ uint8_t get_i2c_address();
 bool clock_is_running(int index);
 
 /**
- * Set the clock state by running motors
+ * Check if a hand of the clock turns without end (ROTATE_CLOCKWISE, ROTATE_COUNTERCLOCKWISE),
+ * the next frame stops it
+ * @param index     clock index (0 <= index =< 3)
+ * @return true if rotating, false otherwise
+*/
+bool clock_is_rotating(int index);
+
+/**
+ * Gets the angle of a hand
+ * @param index     clock index (0 <= index =< 3)
+ * @param hand      0 = hour hand, 1 = minute hand
+ * @return angle, moves in progress included
+*/
+int get_hand_angle(int index, int hand);
+
+/**
+ * Check if the drivers are enabled
+ * @return true if TMC_ENN is active, false otherwise
+*/
+bool get_drivers_enabled();
+
+/**
+ * Gets the hands whose position was lost by a power cut during a move
+ * @return bitmask, bit = motor index (2 * clock + 0 for hour, + 1 for minute)
+*/
+uint8_t get_uncertain_hands();
+
+/**
+ * Check if the drivers are "disabled" with a low hold current, hands are held in place
+*/
+bool get_drivers_standby();
+
+/**
+ * Gets the last telemetry read from a driver
+ * @param motor     motor index (0 <= motor < 6)
+*/
+t_tmc_status get_driver_status(int motor);
+
+/**
+ * Sets how long a motor stays energized after its last step,
+ * CMD_DRIVERS_ENABLE wakes all motors and restarts the timers
+ * @param seconds   idle timeout, 0 = never
+*/
+void set_idle_timeout(uint16_t seconds);
+
+/**
+ * Gets the motors de-energized after an idle timeout
+ * @return bitmask, bit = motor index
+*/
+uint8_t get_gated_motors();
+
+/**
+ * Gets the time spent in a power state since boot, summed over the 6 motors
+ * @param state     power state of type power_states
+ * @return motor-seconds
+*/
+uint32_t get_power_seconds(int state);
+
+/**
+ * Requests a homing of all hands, it starts on core 1 once the motors are stopped
+*/
+void board_home();
+
+/**
+ * Check if a homing is requested or running
+*/
+bool is_homing();
+
+/**
+ * Gets the hands that found the stop during the last homing
+ * @return bitmask, bit = motor index
+*/
+uint8_t get_homed_hands();
+
+/**
+ * Gets the error found by the last homing
+ * @param motor     motor index (0 <= motor < 6)
+ * @return believed angle minus real angle, in degrees (-180 <= offset < 180)
+*/
+int get_home_offset(int motor);
+
+/**
+ * Set the clock state by running motors, the hands started together
+ * arrive together (see COORDINATE_HANDS)
  * @param index     clock index (0 <= index =< 3)
  * @param state     clock state
 */
@@ -52,7 +146,8 @@ void adjust_h_hand(int index, signed char amount);
 void adjust_m_hand(int index, signed char amount);
 
 /**
- * Enable or disable stepper drivers (TMC_ENN pin)
+ * Enable or disable stepper drivers, disabled drivers keep TMC_STANDBY_CURRENT
+ * when all of them answer on UART, TMC_ENN is released otherwise
  * @param enabled   true = drivers enabled (LOW), false = request disable (deferred until motors stop)
 */
 void set_drivers_enabled(bool enabled);
@@ -1,7 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#define STEPS 5760 // 360 * 16
+#define STEPS 5760 // 720 full steps per dial turn at 1/8 microstepping
 //#define STEPS 46080 // 360 * 128
 
 #define A_STEP 1// f(scx)
@@ -21,6 +21,65 @@
 
 #define TMC_ENN 12 // Enable pin for all drivers (low active)
 
+// TMC2209 UART, single wire PDN_UART (1k between TX and RX), 2 buses of 3 drivers
+// Not routed on the current PCB revision, pins to be checked (see PINOUT.md):
+// until then the pins are left alone and the drivers are driven by TMC_ENN only
+#define TMC_UART_ENABLED false
+#define TMC_UART_BAUD 115200
+#define TMC_BUS0_TX 6
+#define TMC_BUS0_RX 7
+#define TMC_BUS1_TX 8
+#define TMC_BUS1_RX 9
+// Bus and address (MS1/MS2 pins) of each motor, same order as _motors (F, E, D, C, B, A)
+#define TMC_BUS_MAP {0, 0, 0, 1, 1, 1}
+#define TMC_ADDR_MAP {0, 1, 2, 0, 1, 2}
+
+// Driver settings written over UART at boot, the MS1/MS2 straps only set the address
+#define TMC_MICROSTEPS 8        // 1/8 gives the 5760 STEPS of a dial turn
+#define TMC_RUN_CURRENT 16      // IRUN, 0..31 of the VREF scale
+#define TMC_HOLD_CURRENT 6      // IHOLD once the motor stopped for TMC_POWER_DOWN
+#define TMC_STANDBY_CURRENT 2   // IHOLD while the drivers are "disabled", hands stay in place
+#define TMC_HOLD_DELAY 4        // IHOLDDELAY, smooth current decrease
+#define TMC_POWER_DOWN 20       // TPOWERDOWN, about 0.4 s
+#define TMC_SPREADCYCLE false   // StealthChop is silent and needed by the homing
+#define TMC_POLL_INTERVAL 100   // ms between two DRV_STATUS reads (one motor each)
+#define TMC_POLL_MAX_SPEED 400  // steps/sec, UART reads block the step loop for about 1 ms
+
+// Motors idle for longer than this are de-energized, until the master sets its own (s, 0 = never)
+#define IDLE_TIMEOUT_DEFAULT 0
+// Power state accounting period (ms)
+#define POWER_TICK 100
+
+// Hands started together arrive together: the faster ones get a lower speed and acceleration.
+// COORDINATE_OFF, COORDINATE_DIAL (the two hands of a clock) or COORDINATE_BOARD (all six)
+#define COORDINATE_OFF 0
+#define COORDINATE_DIAL 1
+#define COORDINATE_BOARD 2
+#define COORDINATE_HANDS COORDINATE_DIAL
+
+// Rotating hands follow the bus time: their speed is trimmed towards the
+// angle they should have, by ROTATE_TRIM_GAIN steps/sec per step behind,
+// at most 1/ROTATE_MAX_TRIM of the rotation speed
+#define ROTATE_TRIM_INTERVAL 100  // ms
+#define ROTATE_TRIM_GAIN 1
+#define ROTATE_MAX_TRIM 4
+
+// Timed frames waiting for their start, per board (see schedule.h)
+#define SCHEDULE_QUEUE_SIZE 8
+// Bus time corrections bigger than this are applied at once, e.g. master restarted (µs)
+#define SYNC_MAX_STEP 2000
+
+// Sensorless homing, hands are driven against a mechanical stop on the dial
+#define HOME_STOP_ANGLE 0       // hand angle at the stop
+#define HOME_DIRECTION 1        // 1 = positive steps, -1 = negative steps
+#define HOME_SPEED 600          // steps/sec, StallGuard needs a steady speed
+#define HOME_ACCEL 1200         // steps/sec^2
+#define HOME_SKIP_STEPS 480     // no stall detection while accelerating
+#define HOME_MAX_STEPS (STEPS + STEPS / 4)  // give up after 1.25 revolutions
+#define HOME_SG_THRESHOLD 20    // SGTHRS, stall when SG_RESULT <= 2 * SGTHRS
+#define HOME_RETURN_SPEED 800   // move back to the previous target
+#define HOME_RETURN_ACCEL 400
+
 // Inversion des DIR (0 = normal, 1 = inversé)
 // Tous inversés suite aux tests du 2025-12-25
 #define INVERT_A_DIR 1
@@ -13,6 +13,7 @@ class ClockAccelStepper : public AccelStepper
     int _current_angle;
     int _max_steps;
     bool _reverse;
+    int _rotating;      // 1 = clockwise, -1 = counterclockwise, 0 = moving to a target
 
   public:
     explicit ClockAccelStepper(uint8_t interface = AccelStepper::FULL4WIRE, uint8_t pin1 = 2, uint8_t pin2 = 3, uint8_t pin3 = 4, uint8_t pin4 = 5, bool enable = true);
@@ -57,6 +58,55 @@ class ClockAccelStepper : public AccelStepper
      * @param direction   direction
     */
     void moveToAngle(int angle, int direction);
+
+    /**
+     * Turns without end, the target is kept whole turns ahead.
+     * Speed and acceleration as set by setMaxSpeed() and setAcceleration().
+     * @param clockwise   direction
+    */
+    void rotate(bool clockwise);
+
+    /**
+     * Pushes the target of a rotating hand further, call it often.
+    */
+    void keepRotating();
+
+    /**
+     * Check if the hand turns without end.
+    */
+    bool isRotating();
+
+    /**
+     * Ends a rotation on an angle, the same way it turns, at least
+     * brake_steps away so the hand slows down with its acceleration.
+     * @param angle         angle to stop at (0 <= angle < 360)
+     * @param brake_steps   distance needed to stop
+    */
+    void stopRotation(int angle, long brake_steps);
+
+    /**
+     * Returns the hand position with the full step resolution.
+     * @return steps from angle 0 (0 <= steps < max motor steps)
+    */
+    long getHandSteps();
+
+    /**
+     * Stops the hand immediately and sets its angle at the current position.
+     * @param angle   (0 <= angle < 360)
+    */
+    void stopAtAngle(int angle);
+
+    /**
+     * Returns the angle of the last moveToAngle() target.
+     * @return angle (0 <= angle < 360)
+    */
+    int getTargetAngle();
+
+    /**
+     * Returns the angle the hand is at, moves in progress included.
+     * @return angle (0 <= angle < 360)
+    */
+    int getHandAngle();
 };
 
 #endif
\ No newline at end of file
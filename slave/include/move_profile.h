@@ -0,0 +1,32 @@
+#ifndef MOVE_PROFILE_H
+#define MOVE_PROFILE_H
+
+#include <Arduino.h>
+
+/**
+ * Trapezoidal moves of the hands, how long they last and how much they
+ * slow down to arrive together (COORDINATE_HANDS in board_config.h).
+ * Pure math, the native tests build it as it is.
+*/
+
+/**
+ * Gets the duration of a move, same model as estimate_move_ms() on the master
+ * @param steps   distance (steps > 0)
+ * @param speed   max speed (steps/s)
+ * @param accel   acceleration (steps/s²)
+ * @return s
+*/
+float move_seconds(float steps, float speed, float accel);
+
+/**
+ * Gets the factor for both the speed and the acceleration of a move to last
+ * a given time, the ramps keep their duration so the profile just stretches
+ * @param steps     distance (steps > 0)
+ * @param speed     max speed (steps/s)
+ * @param accel     acceleration (steps/s²)
+ * @param seconds   duration to reach, at least move_seconds()
+ * @return factor, 1 or less
+*/
+float stretch_factor(float steps, float speed, float accel, float seconds);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef POSITION_JOURNAL_H
+#define POSITION_JOURNAL_H
+
+#include <Arduino.h>
+
+/**
+ * Append-only log of the hands position in flash, survives power loss.
+ * Every record is a full snapshot of the 6 hands, the newest valid one wins.
+ * The log is a ring over the filesystem area (board_build.filesystem_size),
+ * the oldest sector is erased while the motors are stopped.
+*/
+
+#define JOURNAL_RECORD_SIZE 32
+
+enum journal_record_types
+{
+  JOURNAL_INTENT = 1,   // a move is starting, hands in moving may be anywhere between from and angle
+  JOURNAL_DONE = 2      // all hands stopped at angle
+};
+
+typedef struct __attribute__((packed)) journal_record
+{
+  uint32_t sequence;    // increasing, 0xFFFFFFFF = empty slot
+  uint8_t type;
+  uint8_t moving;       // bitmask of the moving hands (bit = motor index)
+  uint16_t angle[6];    // target (INTENT) or position (DONE) of each hand
+  uint16_t from[6];     // position of each hand when the move started
+  uint16_t crc;
+} t_journal_record;
+
+/**
+ * Reads the log and returns the last known hands position
+ * @param angle       hands angle, unchanged if the log is empty
+ * @param uncertain   bitmask of the hands interrupted during a move
+ * @return true if a record was found, false otherwise
+*/
+bool journal_begin(uint16_t angle[6], uint8_t &uncertain);
+
+/**
+ * Logs a move before the motors start, pauses the other core for about 1 ms
+ * @param from      current angle of each hand
+ * @param to        target angle of each hand
+ * @param moving    bitmask of the hands that will move
+*/
+void journal_intent(const uint16_t from[6], const uint16_t to[6], uint8_t moving);
+
+/**
+ * Logs the final position once all motors stopped
+ * @param angle     angle of each hand
+*/
+void journal_done(const uint16_t angle[6]);
+
+/**
+ * Recycles the oldest sector when needed, call only while all motors are stopped
+*/
+void journal_loop();
+
+/**
+ * Gets the number of records written since boot
+*/
+uint32_t journal_get_writes();
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <Arduino.h>
+#include "clock_state.h"
+
+/**
+ * Timed frames: the master uploads frames ahead with a start time on a
+ * bus-wide clock, kept in sync by the CMD_SYNC general call. Frames wait
+ * here until the bus time reaches their start, in arrival order.
+ * Pushes and syncs come from the I2C callback (core 0), pops from core 1.
+*/
+
+/**
+ * Claims the spin lock of the queue
+*/
+void schedule_begin();
+
+/**
+ * Aligns the bus time on the master, first sync or a jump are taken at once,
+ * small differences are filtered
+ * @param bus_us    master bus time (µs), latency already added by the master
+*/
+void schedule_sync(uint32_t bus_us);
+
+/**
+ * Check if a sync beacon was received
+*/
+bool schedule_synced();
+
+/**
+ * Returns the bus time
+ * @return µs, wraps every 71 minutes
+*/
+uint32_t schedule_now();
+
+/**
+ * Queues a frame
+ * @param frame   frame and its start time
+ * @return true if queued, false if the queue is full (frame dropped)
+*/
+bool schedule_push(const t_timed_half_digit &frame);
+
+/**
+ * Takes the oldest frame if its start time has come
+ * @param frame   frame to apply
+ * @return true if a frame is due, false otherwise
+*/
+bool schedule_pop_due(t_half_digit &frame);
+
+/**
+ * Drops all waiting frames, an immediate frame overrides the schedule
+*/
+void schedule_clear();
+
+/**
+ * Gets the number of waiting frames
+*/
+uint8_t schedule_pending();
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef TMC2209_H
+#define TMC2209_H
+
+#include <Arduino.h>
+#include "board_config.h"
+
+// Registers used by the firmware (TMC2209 datasheet, chapter 5)
+#define TMC_REG_GCONF 0x00
+#define TMC_REG_GSTAT 0x01
+#define TMC_REG_IFCNT 0x02
+#define TMC_REG_IHOLD_IRUN 0x10
+#define TMC_REG_TPOWERDOWN 0x11
+#define TMC_REG_TPWMTHRS 0x13
+#define TMC_REG_TCOOLTHRS 0x14
+#define TMC_REG_SGTHRS 0x40
+#define TMC_REG_SG_RESULT 0x41
+#define TMC_REG_CHOPCONF 0x6C
+#define TMC_REG_DRV_STATUS 0x6F
+
+// GCONF: I_scale_analog, pdn_disable (UART on PDN_UART), mstep_reg_select (MRES from CHOPCONF),
+// multistep_filt, StealthChop on
+#define TMC_GCONF_DEFAULT 0x000001C1
+#define TMC_GCONF_SPREADCYCLE 0x00000004
+// CHOPCONF reset value without MRES: TOFF=3, HSTRT=5, TBL=2, intpol
+#define TMC_CHOPCONF_DEFAULT 0x10000053
+
+enum tmc_flags
+{
+  TMC_OVERTEMP = 0x01,          // ot, driver shut down
+  TMC_OVERTEMP_WARNING = 0x02,  // otpw
+  TMC_SHORT = 0x04,             // s2ga, s2gb, s2vsa, s2vsb
+  TMC_OPEN_LOAD = 0x08,         // ola, olb, only meaningful while moving
+  TMC_STANDSTILL = 0x10,        // stst
+  TMC_NO_ANSWER = 0x80          // no valid UART reply
+};
+
+enum tmc_read_results
+{
+  TMC_READ_PENDING,
+  TMC_READ_DONE,
+  TMC_READ_FAILED
+};
+
+// A register read in progress, see tmc_read_start()
+typedef struct tmc_pending_read
+{
+  bool active;
+  int motor;
+  uint8_t reg;
+  uint8_t received;         // bytes read back, the 4 echoed ones first
+  uint8_t reply[8];
+  uint32_t start;           // millis() of the request
+} t_tmc_pending_read;
+
+typedef struct tmc_config
+{
+  uint16_t microsteps;      // 1..256, power of 2
+  uint8_t run_current;      // IRUN, 0..31 of the VREF scale
+  uint8_t hold_current;     // IHOLD, applied TPOWERDOWN after the last step
+  uint8_t hold_delay;       // IHOLDDELAY, 0..15
+  uint8_t power_down;       // TPOWERDOWN, about 21 ms per unit
+  bool spread_cycle;        // false = StealthChop (needed by StallGuard)
+} t_tmc_config;
+
+typedef struct tmc_status
+{
+  uint8_t flags;            // see tmc_flags
+  uint8_t temperature;      // highest threshold passed: 0, 120, 143, 150 or 157 °C
+  uint8_t current;          // CS_ACTUAL, 0..31
+  uint8_t load;             // SG_RESULT / 2 while moving, lower = more load, 0xFF at standstill
+} t_tmc_status;
+
+/**
+ * Starts the UART buses, nothing if TMC_UART_ENABLED is false
+*/
+void tmc_begin();
+
+/**
+ * Writes microstepping, currents and chopper mode, clears GSTAT
+ * @param motor     motor index (0 <= motor < 6)
+ * @param config    driver configuration
+ * @return true if all registers were acknowledged, false otherwise
+*/
+bool tmc_configure(int motor, const t_tmc_config &config);
+
+/**
+ * Changes the hold current only, IRUN stays as configured
+ * @param motor     motor index (0 <= motor < 6)
+ * @param config    driver configuration
+ * @param hold      IHOLD, 0..31
+ * @return true if acknowledged, false otherwise
+*/
+bool tmc_set_hold_current(int motor, const t_tmc_config &config, uint8_t hold);
+
+/**
+ * Reads DRV_STATUS, and SG_RESULT while moving, blocks for 1 to 2 ms
+ * @param motor     motor index (0 <= motor < 6)
+ * @param status    decoded status, flags = TMC_NO_ANSWER on failure
+ * @return true if a valid reply was received, false otherwise
+*/
+bool tmc_read_status(int motor, t_tmc_status &status);
+
+/**
+ * Writes a driver register
+ * @param motor     motor index (0 <= motor < 6)
+ * @param reg       register address
+ * @param value     register value
+ * @return true if the driver acknowledged the write (IFCNT changed), false otherwise
+*/
+bool tmc_write(int motor, uint8_t reg, uint32_t value);
+
+/**
+ * Reads a driver register, blocks for about 1 ms
+ * @param motor     motor index (0 <= motor < 6)
+ * @param reg       register address
+ * @param value     register value
+ * @return true if a valid reply was received, false otherwise
+*/
+bool tmc_read(int motor, uint8_t reg, uint32_t &value);
+
+/**
+ * Sends a register read request and returns, the reply is collected by tmc_read_poll()
+ * @param motor     motor index (0 <= motor < 6)
+ * @param reg       register address
+ * @param read      state of the read, one at a time per bus
+ * @return true if the request was sent, false otherwise
+*/
+bool tmc_read_start(int motor, uint8_t reg, t_tmc_pending_read &read);
+
+/**
+ * Collects the reply bytes received so far, never blocks
+ * @param read      read started by tmc_read_start()
+ * @param value     register value, set once done
+ * @return TMC_READ_PENDING, TMC_READ_DONE, or TMC_READ_FAILED on timeout or bad reply
+*/
+int tmc_read_poll(t_tmc_pending_read &read, uint32_t &value);
+
+#endif
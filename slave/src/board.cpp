@@ -1,8 +1,58 @@
 #include "board.h"
+#include "position_journal.h"
+#include "tmc2209.h"
+#include "schedule.h"
+#include "move_profile.h"
 
 // Driver enable state
 static bool _pending_disable = false;
+static volatile bool _pending_enable = false;   // hold current to restore, core 1 owns the UART
 static bool _drivers_enabled = true;
+static bool _standby = false;           // "disabled" with a low hold current instead of TMC_ENN
+
+// Idle gating state, runs on core 1
+static volatile uint16_t _idle_timeout = IDLE_TIMEOUT_DEFAULT;
+static uint32_t _idle_since[6];         // millis() of the last step, per motor
+static uint8_t _gated = 0;              // motors at TMC_STANDBY_CURRENT after being idle
+static uint8_t _waking = 0;             // gated motors given a target, hold current not restored yet
+static bool _enn_gated = false;         // TMC_ENN released because the whole board is idle
+static uint32_t _power_ticks[POWER_STATES] = {0};
+static uint32_t _power_last_tick = 0;
+
+// Driver UART state, runs on core 1
+static const t_tmc_config _tmc_config = {
+  TMC_MICROSTEPS, TMC_RUN_CURRENT, TMC_HOLD_CURRENT, TMC_HOLD_DELAY, TMC_POWER_DOWN, TMC_SPREADCYCLE
+};
+static uint8_t _tmc_present = 0;        // drivers that accepted the configuration
+static t_tmc_status _tmc_status[6];
+static int _tmc_poll = 0;               // next driver to poll
+static uint32_t _tmc_last_poll = 0;
+
+// Coordinated arrival, runs on core 1
+static uint8_t _starting = 0;           // motors given a target since the last board_loop()
+static float _move_speed[6];            // speed and acceleration asked by the master
+static float _move_accel[6];
+
+// Rotation state, runs on core 1
+static long _rotate_phase[6];           // hand steps at bus time 0
+static uint8_t _rotate_clockwise = 0;   // bitmask of the hands rotating clockwise
+static uint32_t _rotate_last_trim = 0;
+
+// Position journal state
+static bool _journal_pending = false;   // a move started, not logged yet
+static bool _journal_moving = false;    // a move is logged, waiting for the motors to stop
+static uint8_t _uncertain_hands = 0;    // hands interrupted by a power loss
+
+// Homing state, runs on core 1
+static volatile bool _home_requested = false;
+static uint8_t _homing = 0;             // hands still looking for the stop
+static uint8_t _homed = 0;              // hands that found the stop during the last homing
+static int16_t _home_offset[6] = {0};   // believed angle - stop angle, when found
+static int _home_target[6];             // target to go back to after homing
+static int _home_start_angle[6];
+static long _home_start[6];             // motor position when homing started
+static int _home_poll = 0;              // next hand to poll
+static t_tmc_pending_read _home_read;   // SG_RESULT read in flight
 
 // Define a stepper and the pins it will use
 ClockAccelStepper _motors[6] = {
@@ -33,6 +83,17 @@ void board_begin()
   digitalWrite(TMC_ENN, LOW);
   _drivers_enabled = true;
   _pending_disable = false;
+  tmc_begin();
+  for(int i = 0; i < 6; i++)
+  {
+    _tmc_status[i] = {TMC_NO_ANSWER, 0, 0, 0xFF};
+    if(tmc_configure(i, _tmc_config))
+      _tmc_present |= 1 << i;
+  }
+  Serial.printf("Drivers configured over UART: 0x%02x\n", _tmc_present);
+  for(int i = 0; i < 6; i++)
+    _idle_since[i] = millis();
+  _power_last_tick = millis();
 
   // Init motors
   const bool invert_map[6] = {
@@ -44,11 +105,17 @@ void board_begin()
     INVERT_A_DIR  // 5 -> A_DIR (m clock 2)
   };
 
+  // Hands are where the journal left them, INIT_HANDS_ANGLE on a fresh board
+  uint16_t angles[6];
+  for(int i = 0; i < 6; i++)
+    angles[i] = INIT_HANDS_ANGLE;
+  journal_begin(angles, _uncertain_hands);
+
   for(int i = 0; i < 6; i++)
   {
     _motors[i].setPinsInverted(invert_map[i],  false, false);
     _motors[i].setMaxMotorSteps(STEPS);
-    _motors[i].setHandAngle(INIT_HANDS_ANGLE);
+    _motors[i].setHandAngle(angles[i]);
     _motors[i].setMinPulseWidth(0);
   }
 
@@ -62,13 +129,375 @@ void board_begin()
                (!digitalRead(ADDR_4) << 3);
 }
 
+// Slows down the faster motors of a group to arrive with the slowest one
+static void coordinate(uint8_t motors)
+{
+  float longest = 0;
+  for (int i = 0; i < 6; i++)
+    if (motors & (1 << i) && _motors[i].distanceToGo() != 0 && _move_speed[i] > 0 && _move_accel[i] > 0)
+      longest = max(longest, move_seconds(abs(_motors[i].distanceToGo()), _move_speed[i], _move_accel[i]));
+  if (longest <= 0)
+    return;
+  for (int i = 0; i < 6; i++)
+  {
+    long steps = abs(_motors[i].distanceToGo());
+    if (!(motors & (1 << i)) || steps == 0 || _move_speed[i] <= 0 || _move_accel[i] <= 0)
+      continue;
+    float factor = stretch_factor(steps, _move_speed[i], _move_accel[i], longest);
+    _motors[i].setMaxSpeed(_move_speed[i] * factor);
+    _motors[i].setAcceleration(_move_accel[i] * factor);
+  }
+}
+
+// Bus time lock of the rotating hands, speeds up the ones behind and slows down the ones ahead
+static void trim_rotations()
+{
+  if(!schedule_synced() || millis() - _rotate_last_trim < ROTATE_TRIM_INTERVAL)
+    return;
+  _rotate_last_trim = millis();
+  // The lock is lost once when the bus time wraps (71 min), it comes back within seconds
+  uint32_t now = schedule_now();
+  for(int i = 0; i < 6; i++)
+  {
+    if(!_motors[i].isRotating())
+      continue;
+    // Clockwise = decreasing angle, see ClockAccelStepper::moveToAngle()
+    bool clockwise = _rotate_clockwise & (1 << i);
+    long turned = (long)((int64_t)_move_speed[i] * now / 1000000 % STEPS);
+    long expected = clockwise ? _rotate_phase[i] - turned : _rotate_phase[i] + turned;
+    long behind = clockwise ? _motors[i].getHandSteps() - expected : expected - _motors[i].getHandSteps();
+    behind = ((behind % STEPS) + STEPS + STEPS / 2) % STEPS - STEPS / 2;
+    float trim = constrain((float)behind * ROTATE_TRIM_GAIN, -_move_speed[i] / ROTATE_MAX_TRIM, _move_speed[i] / ROTATE_MAX_TRIM);
+    _motors[i].setMaxSpeed(_move_speed[i] + trim);
+  }
+}
+
+static void keep_rotating()
+{
+  for(int i = 0; i < 6; i++)
+    _motors[i].keepRotating();
+  trim_rotations();
+}
+
+// Steps needed to stop from the current speed
+static long brake_steps(int motor)
+{
+  float speed = _motors[motor].speed();
+  return (long)(speed * speed / (2.0f * _move_accel[motor])) + 1;
+}
+
+// Rotating hands stop on their target angle, e.g. before a homing
+static void stop_rotations()
+{
+  for(int i = 0; i < 6; i++)
+    if(_motors[i].isRotating())
+      _motors[i].stopRotation(_motors[i].getTargetAngle(), brake_steps(i));
+}
+
+// Moves started by set_clock() since the last call, before their first step
+static void coordinate_moves()
+{
+  for (int i = 0; i < 6; i++)
+    if (_motors[i].isRotating())
+      _starting &= ~(1 << i);
+#if COORDINATE_HANDS == COORDINATE_BOARD
+  coordinate(_starting);
+#elif COORDINATE_HANDS == COORDINATE_DIAL
+  for (int i = 0; i < 3; i++)
+    coordinate(_starting & (0x03 << (i * 2)));
+#endif
+  _starting = 0;
+}
+
+// Logs new targets before the motors take their first step
+static void journal_moves()
+{
+  uint16_t from[6];
+  uint16_t to[6];
+  uint8_t moving = 0;
+  for(int i = 0; i < 6; i++)
+  {
+    from[i] = _motors[i].getHandAngle();
+    to[i] = _motors[i].getTargetAngle();
+    if(_motors[i].distanceToGo() != 0)
+      moving |= 1 << i;
+  }
+  if(moving)
+  {
+    journal_intent(from, to, moving);
+    _journal_moving = true;
+  }
+}
+
+// Drives all hands towards the stop, hands whose driver doesn't answer are left alone
+static void start_homing()
+{
+  set_drivers_enabled(true);
+  _homing = 0;
+  _homed = 0;
+  uint16_t angles[6];
+  for(int i = 0; i < 6; i++)
+  {
+    _home_offset[i] = 0;
+    _home_target[i] = _motors[i].getTargetAngle();
+    _home_start_angle[i] = _motors[i].getHandAngle();
+    _home_start[i] = _motors[i].currentPosition();
+    angles[i] = _home_start_angle[i];
+    if(!tmc_write(i, TMC_REG_GCONF, TMC_GCONF_DEFAULT) ||
+       !tmc_write(i, TMC_REG_TCOOLTHRS, 0xFFFFF) ||
+       !tmc_write(i, TMC_REG_SGTHRS, HOME_SG_THRESHOLD))
+    {
+      Serial.printf("Homing: no answer from driver %d\n", i);
+      continue;
+    }
+    _motors[i].setMaxSpeed(HOME_SPEED);
+    _motors[i].setAcceleration(HOME_ACCEL);
+    _motors[i].move(HOME_DIRECTION * (long)HOME_MAX_STEPS);
+    _homing |= 1 << i;
+  }
+  if(_homing)
+  {
+    // A power cut during homing leaves the hands anywhere
+    journal_intent(angles, angles, _homing);
+    _journal_moving = true;
+  }
+  Serial.printf("Homing started, hands 0x%02x\n", _homing);
+}
+
+static void finish_homing_hand(int index, bool found)
+{
+  // Positive steps decrease the angle, see ClockAccelStepper::moveToAngle()
+  long steps = _motors[index].currentPosition() - _home_start[index];
+  int believed = sanitize_angle(_home_start_angle[index] - (int)(steps * 360 / STEPS));
+  if(found)
+  {
+    int offset = sanitize_angle(believed - HOME_STOP_ANGLE);
+    _home_offset[index] = offset >= 180 ? offset - 360 : offset;
+    _motors[index].stopAtAngle(HOME_STOP_ANGLE);
+    _homed |= 1 << index;
+    _uncertain_hands &= ~(1 << index);
+    Serial.printf("Homing: hand %d found the stop, offset %d\n", index, _home_offset[index]);
+  }
+  else
+  {
+    _motors[index].stopAtAngle(believed);
+    Serial.printf("Homing: hand %d found no stop\n", index);
+  }
+  _homing &= ~(1 << index);
+}
+
+static void homing_loop()
+{
+  // One SG_RESULT read in flight, its reply is collected over the next
+  // calls so the hands keep stepping meanwhile
+  if(_home_read.active)
+  {
+    uint32_t sg_result;
+    int result = tmc_read_poll(_home_read, sg_result);
+    if(result == TMC_READ_PENDING)
+      return;
+    int i = _home_read.motor;
+    if(result == TMC_READ_DONE && (_homing & (1 << i)) && sg_result <= 2 * HOME_SG_THRESHOLD)
+      finish_homing_hand(i, true);
+  }
+  else
+  {
+    int i = _home_poll;
+    _home_poll = (_home_poll + 1) % 6;
+    if(!(_homing & (1 << i)))
+      return;
+    if(_motors[i].distanceToGo() == 0)
+      finish_homing_hand(i, false);
+    else if(labs(_motors[i].currentPosition() - _home_start[i]) > HOME_SKIP_STEPS)
+      tmc_read_start(i, TMC_REG_SG_RESULT, _home_read);
+  }
+
+  if(_homing == 0)
+  {
+    // Back to where the master wanted the hands
+    for(int j = 0; j < 6; j++)
+    {
+      tmc_write(j, TMC_REG_TCOOLTHRS, 0);
+      if(_tmc_present & (1 << j))
+        tmc_configure(j, _tmc_config);
+      _motors[j].setMaxSpeed(HOME_RETURN_SPEED);
+      _motors[j].setAcceleration(HOME_RETURN_ACCEL);
+      _motors[j].moveToAngle(_home_target[j], MIN_DISTANCE);
+    }
+    _journal_pending = true;
+    Serial.printf("Homing done, hands found: 0x%02x\n", _homed);
+  }
+}
+
+// A UART access blocks the step loop, a motor this fast would miss steps
+static bool any_motor_fast()
+{
+  for(int i = 0; i < 6; i++)
+  {
+    if(fabs(_motors[i].speed()) > TMC_POLL_MAX_SPEED)
+      return true;
+  }
+  return false;
+}
+
+// Reads one driver every TMC_POLL_INTERVAL, skipped when a fast move would miss steps
+static void poll_drivers()
+{
+  if(_homing || millis() - _tmc_last_poll < TMC_POLL_INTERVAL || any_motor_fast())
+    return;
+  _tmc_last_poll = millis();
+  if(_tmc_present & (1 << _tmc_poll))
+    tmc_read_status(_tmc_poll, _tmc_status[_tmc_poll]);
+  _tmc_poll = (_tmc_poll + 1) % 6;
+}
+
+// Also the wake up sent by the master ahead of a move, idle timers restart
+static void process_pending_enable()
+{
+  if(!_pending_enable)
+    return;
+  _pending_enable = false;
+  for(int i = 0; i < 6; i++)
+  {
+    if(_standby || (_gated & (1 << i)))
+      tmc_set_hold_current(i, _tmc_config, _tmc_config.hold_current);
+    _idle_since[i] = millis();
+  }
+  _standby = false;
+  _gated = 0;
+  _waking = 0;
+  _enn_gated = false;
+}
+
+// Energizes the gated motors that got a new target, before their first step.
+// With a motor running fast the UART write waits until none is: a moving
+// motor runs on IRUN, the standby IHOLD only matters once it stops again
+static void wake_moving_motors()
+{
+  if(_enn_gated && !all_motors_stopped())
+  {
+    digitalWrite(TMC_ENN, LOW);
+    _enn_gated = false;
+  }
+  for(int i = 0; _gated && i < 6; i++)
+  {
+    if((_gated & (1 << i)) && _motors[i].distanceToGo() != 0)
+      _waking |= 1 << i;
+  }
+  if(!_waking || any_motor_fast())
+    return;
+  for(int i = 0; i < 6; i++)
+  {
+    if(_waking & (1 << i))
+      tmc_set_hold_current(i, _tmc_config, _tmc_config.hold_current);
+  }
+  _gated &= ~_waking;
+  _waking = 0;
+}
+
+// Motors with a UART keep some holding torque, the others share TMC_ENN
+// which is released only once the whole board is idle
+static void gate_idle_motors()
+{
+  uint32_t now = millis();
+  uint8_t idle = 0;
+  for(int i = 0; i < 6; i++)
+  {
+    if(_motors[i].distanceToGo() != 0)
+      _idle_since[i] = now;
+    else if(_idle_timeout && now - _idle_since[i] >= _idle_timeout * 1000UL)
+      idle |= 1 << i;
+  }
+  if(!_drivers_enabled || _homing || idle == 0)
+    return;
+
+  // Deferred while a motor runs fast, the UART writes would block its steps
+  for(int i = 0; !any_motor_fast() && i < 6; i++)
+  {
+    uint8_t bit = 1 << i;
+    if(!(idle & _tmc_present & ~_gated & bit))
+      continue;
+    if(tmc_set_hold_current(i, _tmc_config, TMC_STANDBY_CURRENT))
+      _gated |= bit;
+    else
+      _tmc_present &= ~bit;   // don't retry on every loop, TMC_ENN takes over
+  }
+  if(idle == 0x3F && _tmc_present != 0x3F && !_enn_gated)
+  {
+    digitalWrite(TMC_ENN, HIGH);
+    _enn_gated = true;
+  }
+}
+
+static uint8_t get_power_state(int motor)
+{
+  if(_motors[motor].distanceToGo() != 0)
+    return POWER_RUN;
+  if(_enn_gated || (!_drivers_enabled && !_standby))
+    return POWER_OFF;
+  if(_standby || (_gated & (1 << motor)))
+    return POWER_STANDBY;
+  return POWER_HOLD;
+}
+
+static void count_power()
+{
+  while(millis() - _power_last_tick >= POWER_TICK)
+  {
+    _power_last_tick += POWER_TICK;
+    for(int i = 0; i < 6; i++)
+      _power_ticks[get_power_state(i)]++;
+  }
+}
+
 void board_loop()
 {
+  process_pending_enable();
+  wake_moving_motors();
+
+  if(_journal_pending)
+  {
+    _journal_pending = false;
+    journal_moves();
+  }
+
+  if(_starting)
+    coordinate_moves();
+  keep_rotating();
+  // A homing starts once all hands stopped
+  if(_home_requested && !_homing)
+    stop_rotations();
+
   for(int i = 0; i < 6; i++)
     _motors[i].run();
 
+  if(_home_requested && !_homing && all_motors_stopped())
+  {
+    _home_requested = false;
+    start_homing();
+  }
+  if(_homing)
+    homing_loop();
+
+  if(all_motors_stopped())
+  {
+    if(_journal_moving)
+    {
+      uint16_t angles[6];
+      for(int i = 0; i < 6; i++)
+        angles[i] = _motors[i].getTargetAngle();
+      journal_done(angles);
+      _journal_moving = false;
+    }
+    else
+      journal_loop();
+  }
+
   // Check if we need to disable drivers after motors stop
   process_pending_disable();
+  gate_idle_motors();
+  poll_drivers();
+  count_power();
 }
 
 uint8_t get_i2c_address()
@@ -76,26 +505,121 @@ uint8_t get_i2c_address()
   return _i2c_address;
 }
 
+bool clock_is_rotating(int index)
+{
+  if( index < 0 || index > 2)
+    return false;
+  return _motors[index*2].isRotating() || _motors[index*2 + 1].isRotating();
+}
+
 bool clock_is_running(int index)
 {
   if( index < 0 || index > 2)
     return false;
 
+  // New targets wait for the end of homing
+  if(_home_requested || _homing)
+    return true;
+
   return _motors[index*2].distanceToGo() != 0 || 
          _motors[index*2 + 1].distanceToGo();
 }
 
-void set_clock(int index, t_clock state)
+int get_hand_angle(int index, int hand)
 {
-  int angle_h = sanitize_angle(state.angle_h + state.adjust_h);
-  _motors[index*2].setMaxSpeed(state.speed_h);
-  _motors[index*2].setAcceleration(state.accel_h);
-  _motors[index*2].moveToAngle(angle_h, state.mode_h);
+  return _motors[index*2 + hand].getHandAngle();
+}
 
-  int angle_m = sanitize_angle(state.angle_m + state.adjust_m);
-  _motors[index*2 + 1].setMaxSpeed(state.speed_m);
-  _motors[index*2 + 1].setAcceleration(state.accel_m);
-  _motors[index*2 + 1].moveToAngle(angle_m, state.mode_m);
+bool get_drivers_enabled()
+{
+  return _drivers_enabled;
+}
+
+bool get_drivers_standby()
+{
+  return _standby;
+}
+
+t_tmc_status get_driver_status(int motor)
+{
+  return _tmc_status[motor];
+}
+
+void set_idle_timeout(uint16_t seconds)
+{
+  _idle_timeout = seconds;
+}
+
+uint8_t get_gated_motors()
+{
+  return _enn_gated ? 0x3F : _gated;
+}
+
+uint32_t get_power_seconds(int state)
+{
+  return _power_ticks[state] / (1000 / POWER_TICK);
+}
+
+uint8_t get_uncertain_hands()
+{
+  return _uncertain_hands;
+}
+
+void board_home()
+{
+  _home_requested = true;
+}
+
+bool is_homing()
+{
+  return _home_requested || _homing;
+}
+
+uint8_t get_homed_hands()
+{
+  return _homed;
+}
+
+int get_home_offset(int motor)
+{
+  return _home_offset[motor];
+}
+
+static void set_hand(int motor, int angle, uint16_t speed, uint16_t accel, uint8_t mode)
+{
+  if((mode == ROTATE_CLOCKWISE || mode == ROTATE_COUNTERCLOCKWISE) && speed > 0)
+  {
+    _motors[motor].setMaxSpeed(speed);
+    _motors[motor].setAcceleration(accel);
+    _motors[motor].rotate(mode == ROTATE_CLOCKWISE);
+    _rotate_phase[motor] = (long)angle * STEPS / 360;
+    if(mode == ROTATE_CLOCKWISE)
+      _rotate_clockwise |= 1 << motor;
+    else
+      _rotate_clockwise &= ~(1 << motor);
+  }
+  else if(_motors[motor].isRotating())
+  {
+    // Brakes the way it turns, with the speed and acceleration of the rotation
+    _motors[motor].stopRotation(angle, brake_steps(motor));
+    return;
+  }
+  else
+  {
+    _motors[motor].setMaxSpeed(speed);
+    _motors[motor].setAcceleration(accel);
+    _motors[motor].moveToAngle(angle, mode > MAX_DISTANCE3 ? MIN_DISTANCE : mode);
+    _starting |= 1 << motor;
+  }
+  _move_speed[motor] = speed;
+  _move_accel[motor] = accel;
+}
+
+void set_clock(int index, t_clock state)
+{
+  set_hand(index*2, sanitize_angle(state.angle_h + state.adjust_h), state.speed_h, state.accel_h, state.mode_h);
+  set_hand(index*2 + 1, sanitize_angle(state.angle_m + state.adjust_m), state.speed_m, state.accel_m, state.mode_m);
+  _journal_pending = true;
 }
 
 void adjust_h_hand(int index, signed char amount)
@@ -103,6 +627,8 @@ void adjust_h_hand(int index, signed char amount)
   int steps = amount * STEPS / 360;
   _motors[index*2 + 1].move(steps);
   _motors[index*2 + 1].runToPosition();
+  // Hand placed by the user, trust it again
+  _uncertain_hands &= ~(1 << (index*2 + 1));
 }
 
 void adjust_m_hand(int index, signed char amount)
@@ -110,6 +636,7 @@ void adjust_m_hand(int index, signed char amount)
   int steps = amount * STEPS / 360;
   _motors[index*2].move(-steps);
   _motors[index*2].runToPosition();
+  _uncertain_hands &= ~(1 << (index*2));
 }
 
 bool all_motors_stopped()
@@ -126,10 +653,11 @@ void set_drivers_enabled(bool enabled)
 {
   if(enabled)
   {
-    // Enable immediately
+    // Enable immediately, the hold current is restored by board_loop()
     digitalWrite(TMC_ENN, LOW);
     _drivers_enabled = true;
     _pending_disable = false;
+    _pending_enable = true;
     Serial.println("Drivers enabled");
   }
   else
@@ -144,9 +672,24 @@ void process_pending_disable()
 {
   if(_pending_disable && _drivers_enabled && all_motors_stopped())
   {
-    digitalWrite(TMC_ENN, HIGH);
+    // TMC_ENN is shared, standby only when every driver answers
+    bool standby = _tmc_present == 0x3F;
+    for(int i = 0; standby && i < 6; i++)
+      standby = tmc_set_hold_current(i, _tmc_config, TMC_STANDBY_CURRENT);
+    if(standby)
+    {
+      _standby = true;
+      Serial.println("Drivers in standby");
+    }
+    else
+    {
+      digitalWrite(TMC_ENN, HIGH);
+      Serial.println("Drivers disabled");
+    }
     _drivers_enabled = false;
     _pending_disable = false;
-    Serial.println("Drivers disabled");
+    _gated = 0;
+    _waking = 0;
+    _enn_gated = false;
   }
 }
\ No newline at end of file
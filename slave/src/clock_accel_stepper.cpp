@@ -5,6 +5,7 @@ ClockAccelStepper::ClockAccelStepper(uint8_t interface, uint8_t pin1, uint8_t pi
 {
   _current_angle = 0;
   _reverse = false;
+  _rotating = 0;
 }
 
 void ClockAccelStepper::setHandAngle(int angle)
@@ -75,4 +76,68 @@ void ClockAccelStepper::moveToAngle(int angle, int direction)
     steps = (steps + (_max_steps * multiplier)) * -1;
 
   move(steps * (_reverse ? -1 : 1));
+}
+
+// Whole turns kept ahead of a rotating hand
+#define ROTATE_TURNS 4
+
+void ClockAccelStepper::rotate(bool clockwise)
+{
+  _rotating = clockwise ? 1 : -1;
+  // Target brought back next to the hand by whole turns, then pushed ahead the new way
+  long target = targetPosition();
+  target -= (target - currentPosition()) / _max_steps * _max_steps;
+  moveTo(target + (long)_max_steps * ROTATE_TURNS * _rotating * (_reverse ? -1 : 1));
+}
+
+void ClockAccelStepper::keepRotating()
+{
+  // Whole turns only, _current_angle stays the angle of the target
+  if (_rotating != 0 && abs(distanceToGo()) < (long)_max_steps * ROTATE_TURNS / 2)
+    moveTo(targetPosition() + (long)_max_steps * ROTATE_TURNS * _rotating * (_reverse ? -1 : 1));
+}
+
+bool ClockAccelStepper::isRotating()
+{
+  return _rotating != 0;
+}
+
+void ClockAccelStepper::stopRotation(int angle, long brake_steps)
+{
+  // Clockwise = positive steps = decreasing angle
+  long delta = _rotating > 0 ? getHandSteps() - (long)angle * _max_steps / 360
+                             : (long)angle * _max_steps / 360 - getHandSteps();
+  delta = ((delta % _max_steps) + _max_steps) % _max_steps;
+  while (delta < brake_steps)
+    delta += _max_steps;
+  moveTo(currentPosition() + delta * _rotating * (_reverse ? -1 : 1));
+  _current_angle = angle;
+  _rotating = 0;
+}
+
+long ClockAccelStepper::getHandSteps()
+{
+  long remaining = distanceToGo() * (_reverse ? -1 : 1);
+  long steps = ((long)_current_angle * _max_steps / 360 + remaining) % _max_steps;
+  return steps < 0 ? steps + _max_steps : steps;
+}
+
+void ClockAccelStepper::stopAtAngle(int angle)
+{
+  _rotating = 0;
+  setCurrentPosition(currentPosition());
+  _current_angle = angle;
+}
+
+int ClockAccelStepper::getTargetAngle()
+{
+  return _current_angle;
+}
+
+int ClockAccelStepper::getHandAngle()
+{
+  // _current_angle is already the target, positive steps left decrease the angle
+  long remaining = distanceToGo() * (_reverse ? -1 : 1);
+  int angle = (_current_angle + (int)(remaining * 360 / _max_steps)) % 360;
+  return angle < 0 ? 360 + angle : angle;
 }
\ No newline at end of file
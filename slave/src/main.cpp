@@ -4,6 +4,7 @@
 #include "board.h"
 #include "clock_state.h"
 #include "i2c.h"
+#include "schedule.h"
 
 const t_clock default_clock = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
@@ -16,6 +17,24 @@ t_half_digit current_clocks_state;
 // I2C command definitions
 #define CMD_DRIVERS_DISABLE 0x00
 #define CMD_DRIVERS_ENABLE  0x01
+#define CMD_HOME            0x02
+#define CMD_IDLE_TIMEOUT    0x03  // followed by uint16_t seconds
+// General call, followed by uint32_t bus time (µs). 0x00, 0x04 and 0x06 are
+// reserved by the I2C spec and odd bytes are hardware general calls, other
+// devices ignore the remaining even bytes
+#define CMD_SYNC            0x10
+
+// Copies a frame to the targets, loop1 starts the clocks that changed
+static void set_target(const t_half_digit &state)
+{
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    spin_lock_unsafe_blocking(spin_lock[i]);
+    target_clocks_state.clocks[i] = state.clocks[i];
+    target_clocks_state.change_counter[i] = state.change_counter[i];
+    spin_unlock_unsafe(spin_lock[i]);
+  }
+}
 
 // I2C runs on main core (core 0)
 void receiveEvent(int how_many)
@@ -37,6 +56,45 @@ void receiveEvent(int how_many)
       Serial.println("I2C cmd: Disable drivers");
       set_drivers_enabled(false);
     }
+    else if (cmd == CMD_HOME)
+    {
+      Serial.println("I2C cmd: Home");
+      board_home();
+    }
+    return;
+  }
+
+  // Bus time beacon, sent to all boards at once on the general call address
+  if (how_many == 5)
+  {
+    uint8_t cmd = Wire.read();
+    uint32_t bus_us;
+    I2C_readAnything(bus_us);
+    if (cmd == CMD_SYNC)
+      schedule_sync(bus_us);
+    return;
+  }
+
+  if (how_many == 3)
+  {
+    uint8_t cmd = Wire.read();
+    uint16_t seconds = Wire.read();
+    seconds |= Wire.read() << 8;
+    if (cmd == CMD_IDLE_TIMEOUT)
+    {
+      Serial.printf("I2C cmd: Idle timeout %u s\n", seconds);
+      set_idle_timeout(seconds);
+    }
+    return;
+  }
+
+  // Timed clock position command, held until its start time
+  if (how_many >= sizeof(t_timed_half_digit))
+  {
+    t_timed_half_digit frame;
+    I2C_readAnything(frame);
+    if (!schedule_push(frame))
+      Serial.println("Schedule full, frame dropped");
     return;
   }
 
@@ -45,6 +103,8 @@ void receiveEvent(int how_many)
   {
     t_half_digit tmp_state;
     I2C_readAnything (tmp_state);
+    // Applied now, waiting frames would undo it
+    schedule_clear();
 
     for (uint8_t i = 0; i < 3; i++)
     {
@@ -54,15 +114,51 @@ void receiveEvent(int how_many)
         tmp_state.clocks[i].mode_m,
         tmp_state.clocks[i].angle_h,
         tmp_state.clocks[i].angle_m);
-
-      spin_lock_unsafe_blocking(spin_lock[i]);
-      target_clocks_state.clocks[i] = tmp_state.clocks[i];
-      target_clocks_state.change_counter[i] = tmp_state.change_counter[i];
-      spin_unlock_unsafe(spin_lock[i]);
     }
+    set_target(tmp_state);
   }
 }
 
+// Answers the master with the believed hand positions, runs on core 0
+void requestEvent()
+{
+  t_board_status status = {BOARD_STATUS_VERSION, 0, get_uncertain_hands(), get_homed_hands(), {0}, {0}, {0}, {0}, {0}, {0}, {0}, {0}, get_gated_motors(), schedule_pending(), {0}};
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    status.angle[i*2] = get_hand_angle(i, 0);
+    status.angle[i*2 + 1] = get_hand_angle(i, 1);
+    status.home_offset[i*2] = get_home_offset(i*2);
+    status.home_offset[i*2 + 1] = get_home_offset(i*2 + 1);
+    if (clock_is_running(i))
+      status.flags |= STATUS_RUNNING;
+
+    spin_lock_unsafe_blocking(spin_lock[i]);
+    status.change_counter[i] = current_clocks_state.change_counter[i];
+    spin_unlock_unsafe(spin_lock[i]);
+  }
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    t_tmc_status driver = get_driver_status(i);
+    status.driver_flags[i] = driver.flags;
+    status.driver_temperature[i] = driver.temperature;
+    status.driver_load[i] = driver.load;
+    status.driver_current[i] = driver.current;
+  }
+  for (uint8_t i = 0; i < POWER_STATES; i++)
+    status.power_seconds[i] = get_power_seconds(i);
+  if (get_drivers_enabled())
+    status.flags |= STATUS_DRIVERS_ENABLED;
+  if (get_drivers_standby())
+    status.flags |= STATUS_DRIVERS_STANDBY;
+  if (status.uncertain)
+    status.flags |= STATUS_POSITION_UNCERTAIN;
+  if (is_homing())
+    status.flags |= STATUS_HOMING;
+  if (schedule_synced())
+    status.flags |= STATUS_SYNCED;
+  I2C_writeAnything(status);
+}
+
 void setup()
 {  
   Serial.begin(115200);
@@ -76,11 +172,14 @@ void setup()
     int spin_num = spin_lock_claim_unused(true); //Claim a free spin lock. If true the function will panic if none are available
     spin_lock[i] = spin_lock_init(spin_num); //Initialise a spin lock
   }
+  schedule_begin();
 
   Wire.setSDA(WIRE_SDA);
   Wire.setSCL(WIRE_SCL);
+  // The RP2040 also acks the general call address (IC_ACK_GENERAL_CALL reset value), used by CMD_SYNC
   Wire.begin(get_i2c_address());
   Wire.onReceive(receiveEvent);
+  Wire.onRequest(requestEvent);
 }
 
 void loop()
@@ -96,10 +195,15 @@ void setup1()
 // Steppers on core 1
 void loop1()
 {
+  t_half_digit due;
+  while (schedule_pop_due(due))
+    set_target(due);
+
   board_loop();
   for (uint8_t i = 0; i < 3; i++)
   {
-    if(!clock_is_running(i) && current_clocks_state.change_counter[i] != target_clocks_state.change_counter[i])
+    // A rotation runs until the next frame
+    if((!clock_is_running(i) || clock_is_rotating(i)) && current_clocks_state.change_counter[i] != target_clocks_state.change_counter[i])
     {
       Serial.printf("Updating clock %d\n", i);
       
@@ -120,7 +224,7 @@ void loop1()
         adjust_m_hand(i, current_clocks_state.clocks[i].adjust_m);
       }
 
-      if(current_clocks_state.clocks[i].mode_h <= MAX_DISTANCE3) {
+      if(current_clocks_state.clocks[i].mode_h != ADJUST_HAND) {
         Serial.printf("Setting clock %d to H: %d°, M: %d°\n", 
           i, 
           current_clocks_state.clocks[i].angle_h,
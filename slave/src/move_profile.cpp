@@ -0,0 +1,21 @@
+#include "move_profile.h"
+
+float move_seconds(float steps, float speed, float accel)
+{
+  if (steps >= speed * speed / accel)
+    return steps / speed + speed / accel;
+  return 2.0f * sqrtf(steps / accel);
+}
+
+float stretch_factor(float steps, float speed, float accel, float seconds)
+{
+  float ramp = speed / accel;
+  if (seconds > ramp)
+  {
+    float factor = steps / (speed * (seconds - ramp));
+    // Still reaches the cruise speed once slowed down
+    if (factor * speed * speed / accel <= steps)
+      return min(1.0f, factor);
+  }
+  return min(1.0f, 4.0f * steps / (accel * seconds * seconds));
+}
@@ -0,0 +1,202 @@
+#include "position_journal.h"
+#include <stddef.h>
+#include <hardware/flash.h>
+#include <hardware/sync.h>
+
+// Filesystem area reserved by the linker script, see platformio.ini
+extern uint8_t _FS_start;
+extern uint8_t _FS_end;
+
+static_assert(sizeof(t_journal_record) == JOURNAL_RECORD_SIZE, "journal record size");
+static_assert(FLASH_PAGE_SIZE % JOURNAL_RECORD_SIZE == 0, "records can't cross pages");
+
+#define RECORDS_PER_SECTOR (FLASH_SECTOR_SIZE / JOURNAL_RECORD_SIZE)
+#define EMPTY_SEQUENCE 0xFFFFFFFF
+
+static uint32_t _journal_offset = 0;   // flash offset of the log
+static uint32_t _journal_slots = 0;    // 0 = no log area
+static uint32_t _journal_next = 0;     // next slot to write
+static uint32_t _journal_sequence = 0; // sequence of the last record
+static bool _journal_erase_pending = false;
+static uint32_t _journal_writes = 0;
+
+static const t_journal_record *get_slot(uint32_t slot)
+{
+  return (const t_journal_record *)(uintptr_t)(XIP_BASE + _journal_offset + slot * JOURNAL_RECORD_SIZE);
+}
+
+// CRC-16/CCITT
+static uint16_t record_crc(const t_journal_record *record)
+{
+  const uint8_t *data = (const uint8_t *)record;
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < offsetof(t_journal_record, crc); i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int j = 0; j < 8; j++)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+static bool is_blank(const uint8_t *data, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+    if (data[i] != 0xFF)
+      return false;
+  return true;
+}
+
+static bool is_valid(const t_journal_record *record)
+{
+  return record->sequence != EMPTY_SEQUENCE &&
+         (record->type == JOURNAL_INTENT || record->type == JOURNAL_DONE) &&
+         record->crc == record_crc(record);
+}
+
+static bool is_sector_blank(uint32_t sector)
+{
+  return is_blank((const uint8_t *)get_slot(sector * RECORDS_PER_SECTOR), FLASH_SECTOR_SIZE);
+}
+
+// Flash is not readable while erasing or programming, core 0 (I2C) is paused
+static void erase_sector(uint32_t sector)
+{
+  rp2040.idleOtherCore();
+  uint32_t irq = save_and_disable_interrupts();
+  flash_range_erase(_journal_offset + sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE);
+  restore_interrupts(irq);
+  rp2040.resumeOtherCore();
+}
+
+static void program_record(uint32_t slot, const t_journal_record &record)
+{
+  // Erased bytes programmed with 0xFF stay untouched, only the record is written
+  static uint8_t page[FLASH_PAGE_SIZE];
+  uint32_t address = slot * JOURNAL_RECORD_SIZE;
+  memset(page, 0xFF, sizeof(page));
+  memcpy(page + address % FLASH_PAGE_SIZE, &record, sizeof(record));
+  rp2040.idleOtherCore();
+  uint32_t irq = save_and_disable_interrupts();
+  flash_range_program(_journal_offset + address - address % FLASH_PAGE_SIZE, page, FLASH_PAGE_SIZE);
+  restore_interrupts(irq);
+  rp2040.resumeOtherCore();
+}
+
+static void append(t_journal_record &record)
+{
+  if (_journal_slots == 0)
+    return;
+  // Skip slots left half written by a power loss
+  while (!is_blank((const uint8_t *)get_slot(_journal_next), JOURNAL_RECORD_SIZE))
+  {
+    if (_journal_next % RECORDS_PER_SECTOR == 0)
+    {
+      // Sector not recycled in time, erase it now
+      erase_sector(_journal_next / RECORDS_PER_SECTOR);
+      _journal_erase_pending = false;
+      break;
+    }
+    _journal_next = (_journal_next + 1) % _journal_slots;
+  }
+
+  record.sequence = ++_journal_sequence;
+  record.crc = record_crc(&record);
+  program_record(_journal_next, record);
+  _journal_writes++;
+
+  _journal_next = (_journal_next + 1) % _journal_slots;
+  if (_journal_next % RECORDS_PER_SECTOR == 0)
+  {
+    // Entered a new sector, the one after it is recycled while the motors are stopped
+    uint32_t sectors = _journal_slots / RECORDS_PER_SECTOR;
+    _journal_erase_pending = !is_sector_blank((_journal_next / RECORDS_PER_SECTOR + 1) % sectors);
+  }
+}
+
+bool journal_begin(uint16_t angle[6], uint8_t &uncertain)
+{
+  uncertain = 0;
+  _journal_offset = (uintptr_t)&_FS_start - XIP_BASE;
+  _journal_slots = ((uintptr_t)&_FS_end - (uintptr_t)&_FS_start) / FLASH_SECTOR_SIZE * RECORDS_PER_SECTOR;
+  if (_journal_slots < 2 * RECORDS_PER_SECTOR)
+  {
+    Serial.println("Position journal disabled: filesystem area too small");
+    _journal_slots = 0;
+    return false;
+  }
+
+  // Newest valid record
+  const t_journal_record *last = NULL;
+  uint32_t last_slot = 0;
+  for (uint32_t i = 0; i < _journal_slots; i++)
+  {
+    const t_journal_record *record = get_slot(i);
+    if (is_valid(record) && (last == NULL || record->sequence > last->sequence))
+    {
+      last = record;
+      last_slot = i;
+    }
+  }
+
+  uint32_t sectors = _journal_slots / RECORDS_PER_SECTOR;
+  if (last == NULL)
+  {
+    _journal_next = 0;
+    _journal_sequence = 0;
+    _journal_erase_pending = !is_sector_blank(1);
+    Serial.println("Position journal empty");
+    return false;
+  }
+
+  _journal_next = (last_slot + 1) % _journal_slots;
+  _journal_sequence = last->sequence;
+  _journal_erase_pending = !is_sector_blank((_journal_next / RECORDS_PER_SECTOR + 1) % sectors);
+  for (int i = 0; i < 6; i++)
+    angle[i] = last->angle[i] % 360;
+  if (last->type == JOURNAL_INTENT)
+    uncertain = last->moving;
+  Serial.printf("Position journal: record %lu, %s\n", (unsigned long)last->sequence,
+    uncertain ? "move interrupted" : "hands stopped");
+  return true;
+}
+
+void journal_intent(const uint16_t from[6], const uint16_t to[6], uint8_t moving)
+{
+  t_journal_record record;
+  record.type = JOURNAL_INTENT;
+  record.moving = moving;
+  for (int i = 0; i < 6; i++)
+  {
+    record.angle[i] = to[i];
+    record.from[i] = from[i];
+  }
+  append(record);
+}
+
+void journal_done(const uint16_t angle[6])
+{
+  t_journal_record record;
+  record.type = JOURNAL_DONE;
+  record.moving = 0;
+  for (int i = 0; i < 6; i++)
+  {
+    record.angle[i] = angle[i];
+    record.from[i] = angle[i];
+  }
+  append(record);
+}
+
+void journal_loop()
+{
+  if (!_journal_erase_pending)
+    return;
+  uint32_t sectors = _journal_slots / RECORDS_PER_SECTOR;
+  erase_sector((_journal_next / RECORDS_PER_SECTOR + 1) % sectors);
+  _journal_erase_pending = false;
+}
+
+uint32_t journal_get_writes()
+{
+  return _journal_writes;
+}
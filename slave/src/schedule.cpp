@@ -0,0 +1,84 @@
+#include "schedule.h"
+#include "board_config.h"
+
+static spin_lock_t *_queue_lock;
+static t_timed_half_digit _queue[SCHEDULE_QUEUE_SIZE];
+static volatile uint8_t _queue_head = 0;
+static volatile uint8_t _queue_count = 0;
+
+// Bus time = micros() + _bus_offset
+static volatile int32_t _bus_offset = 0;
+static volatile bool _synced = false;
+
+void schedule_begin()
+{
+  _queue_lock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+void schedule_sync(uint32_t bus_us)
+{
+  int32_t offset = (int32_t)(bus_us - (uint32_t)micros());
+  int32_t error = offset - _bus_offset;
+  if (!_synced || error > SYNC_MAX_STEP || error < -SYNC_MAX_STEP)
+  {
+    _bus_offset = offset;
+    _synced = true;
+    Serial.printf("Bus time set, offset %ld us\n", (long)offset);
+    return;
+  }
+  // Interrupt latency only delays the beacon, average it out
+  _bus_offset += error / 4;
+}
+
+bool schedule_synced()
+{
+  return _synced;
+}
+
+uint32_t schedule_now()
+{
+  return (uint32_t)micros() + _bus_offset;
+}
+
+bool schedule_push(const t_timed_half_digit &frame)
+{
+  spin_lock_unsafe_blocking(_queue_lock);
+  bool queued = _queue_count < SCHEDULE_QUEUE_SIZE;
+  if (queued)
+  {
+    _queue[(_queue_head + _queue_count) % SCHEDULE_QUEUE_SIZE] = frame;
+    _queue_count++;
+  }
+  spin_unlock_unsafe(_queue_lock);
+  return queued;
+}
+
+bool schedule_pop_due(t_half_digit &frame)
+{
+  if (_queue_count == 0)
+    return false;
+  bool due = false;
+  spin_lock_unsafe_blocking(_queue_lock);
+  // Without a sync the start times mean nothing, frames go at once
+  if (_queue_count > 0 && (!_synced || (int32_t)(schedule_now() - _queue[_queue_head].start_us) >= 0))
+  {
+    frame = _queue[_queue_head].half_digit;
+    _queue_head = (_queue_head + 1) % SCHEDULE_QUEUE_SIZE;
+    _queue_count--;
+    due = true;
+  }
+  spin_unlock_unsafe(_queue_lock);
+  return due;
+}
+
+void schedule_clear()
+{
+  spin_lock_unsafe_blocking(_queue_lock);
+  _queue_count = 0;
+  spin_unlock_unsafe(_queue_lock);
+}
+
+uint8_t schedule_pending()
+{
+  return _queue_count;
+}
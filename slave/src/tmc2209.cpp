@@ -0,0 +1,214 @@
+#include "tmc2209.h"
+
+#define TMC_SYNC 0x05
+#define TMC_MASTER_ADDRESS 0xFF
+#define TMC_WRITE 0x80
+#define TMC_REPLY_TIMEOUT 5   // ms
+
+#if TMC_UART_ENABLED
+SerialPIO _tmc_bus0(TMC_BUS0_TX, TMC_BUS0_RX);
+SerialPIO _tmc_bus1(TMC_BUS1_TX, TMC_BUS1_RX);
+#endif
+
+static const uint8_t _tmc_bus_map[6] = TMC_BUS_MAP;
+static const uint8_t _tmc_addr_map[6] = TMC_ADDR_MAP;
+
+// NULL while the UART is not wired
+static SerialPIO *get_bus(int motor)
+{
+#if TMC_UART_ENABLED
+  return _tmc_bus_map[motor] == 0 ? &_tmc_bus0 : &_tmc_bus1;
+#else
+  return NULL;
+#endif
+}
+
+// CRC8 as in the datasheet, LSB of each byte first
+static uint8_t tmc_crc(const uint8_t *data, int length)
+{
+  uint8_t crc = 0;
+  for (int i = 0; i < length; i++)
+  {
+    uint8_t byte = data[i];
+    for (int j = 0; j < 8; j++)
+    {
+      if ((crc >> 7) ^ (byte & 0x01))
+        crc = (crc << 1) ^ 0x07;
+      else
+        crc = crc << 1;
+      byte >>= 1;
+    }
+  }
+  return crc;
+}
+
+// Single wire bus, everything sent is read back
+static void send(SerialPIO &bus, const uint8_t *data, int length)
+{
+  while (bus.available())
+    bus.read();
+  bus.write(data, length);
+  bus.flush();
+  uint32_t start = millis();
+  int echo = 0;
+  while (echo < length && millis() - start < TMC_REPLY_TIMEOUT)
+  {
+    if (bus.available())
+    {
+      bus.read();
+      echo++;
+    }
+  }
+}
+
+void tmc_begin()
+{
+#if TMC_UART_ENABLED
+  _tmc_bus0.begin(TMC_UART_BAUD);
+  _tmc_bus1.begin(TMC_UART_BAUD);
+#endif
+}
+
+bool tmc_read_start(int motor, uint8_t reg, t_tmc_pending_read &read)
+{
+  read.active = false;
+  SerialPIO *bus = get_bus(motor);
+  if (bus == NULL)
+    return false;
+  while (bus->available())
+    bus->read();
+  uint8_t request[4] = {TMC_SYNC, _tmc_addr_map[motor], reg, 0};
+  request[3] = tmc_crc(request, 3);
+  // Fits in the TX FIFO, no wait
+  bus->write(request, sizeof(request));
+  read.active = true;
+  read.motor = motor;
+  read.reg = reg;
+  read.received = 0;
+  read.start = millis();
+  return true;
+}
+
+int tmc_read_poll(t_tmc_pending_read &read, uint32_t &value)
+{
+  if (!read.active)
+    return TMC_READ_FAILED;
+  SerialPIO *bus = get_bus(read.motor);
+  // Single wire bus, the request is read back before the reply
+  while (read.received < 4 + sizeof(read.reply) && bus->available())
+  {
+    uint8_t data = bus->read();
+    if (read.received >= 4)
+      read.reply[read.received - 4] = data;
+    read.received++;
+  }
+  if (read.received < 4 + sizeof(read.reply))
+  {
+    if (millis() - read.start < TMC_REPLY_TIMEOUT)
+      return TMC_READ_PENDING;
+    read.active = false;
+    return TMC_READ_FAILED;
+  }
+  read.active = false;
+  const uint8_t *reply = read.reply;
+  if (reply[0] != TMC_SYNC || reply[1] != TMC_MASTER_ADDRESS ||
+      reply[2] != read.reg || reply[7] != tmc_crc(reply, 7))
+    return TMC_READ_FAILED;
+  value = (uint32_t)reply[3] << 24 | (uint32_t)reply[4] << 16 | (uint32_t)reply[5] << 8 | reply[6];
+  return TMC_READ_DONE;
+}
+
+bool tmc_read(int motor, uint8_t reg, uint32_t &value)
+{
+  t_tmc_pending_read read;
+  if (!tmc_read_start(motor, reg, read))
+    return false;
+  int result;
+  while ((result = tmc_read_poll(read, value)) == TMC_READ_PENDING)
+    ;
+  return result == TMC_READ_DONE;
+}
+
+bool tmc_write(int motor, uint8_t reg, uint32_t value)
+{
+  SerialPIO *bus = get_bus(motor);
+  if (bus == NULL)
+    return false;
+  // Write only registers have no reply, the interface counter tells if the write landed
+  uint32_t count_before = 0;
+  bool counted = tmc_read(motor, TMC_REG_IFCNT, count_before);
+
+  uint8_t request[8] = {TMC_SYNC, _tmc_addr_map[motor], (uint8_t)(reg | TMC_WRITE),
+                        (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value, 0};
+  request[7] = tmc_crc(request, 7);
+  send(*bus, request, sizeof(request));
+
+  uint32_t count_after = 0;
+  return counted && tmc_read(motor, TMC_REG_IFCNT, count_after) && (uint8_t)count_after == (uint8_t)(count_before + 1);
+}
+
+static uint32_t ihold_irun(const t_tmc_config &config, uint8_t hold)
+{
+  return (uint32_t)(config.hold_delay & 0x0F) << 16 | (uint32_t)(config.run_current & 0x1F) << 8 | (hold & 0x1F);
+}
+
+// MRES: 0 = 256 microsteps ... 8 = full step
+static uint32_t microstep_resolution(uint16_t microsteps)
+{
+  uint32_t mres = 8;
+  while (mres > 0 && (1u << (8 - mres)) < microsteps)
+    mres--;
+  return mres;
+}
+
+bool tmc_configure(int motor, const t_tmc_config &config)
+{
+  uint32_t gconf = TMC_GCONF_DEFAULT | (config.spread_cycle ? TMC_GCONF_SPREADCYCLE : 0);
+  uint32_t chopconf = TMC_CHOPCONF_DEFAULT | microstep_resolution(config.microsteps) << 24;
+  return tmc_write(motor, TMC_REG_GCONF, gconf) &&
+         tmc_write(motor, TMC_REG_CHOPCONF, chopconf) &&
+         tmc_write(motor, TMC_REG_IHOLD_IRUN, ihold_irun(config, config.hold_current)) &&
+         tmc_write(motor, TMC_REG_TPOWERDOWN, config.power_down) &&
+         tmc_write(motor, TMC_REG_TPWMTHRS, 0) &&
+         tmc_write(motor, TMC_REG_GSTAT, 0x07);
+}
+
+bool tmc_set_hold_current(int motor, const t_tmc_config &config, uint8_t hold)
+{
+  return tmc_write(motor, TMC_REG_IHOLD_IRUN, ihold_irun(config, hold));
+}
+
+bool tmc_read_status(int motor, t_tmc_status &status)
+{
+  uint32_t value;
+  status = {TMC_NO_ANSWER, 0, 0, 0xFF};
+  if (!tmc_read(motor, TMC_REG_DRV_STATUS, value))
+    return false;
+
+  status.flags = 0;
+  if (value & 0x02)
+    status.flags |= TMC_OVERTEMP;
+  if (value & 0x01)
+    status.flags |= TMC_OVERTEMP_WARNING;
+  if (value & 0x3C)
+    status.flags |= TMC_SHORT;
+  if (value & 0xC0)
+    status.flags |= TMC_OPEN_LOAD;
+  if (value & 0x80000000)
+    status.flags |= TMC_STANDSTILL;
+
+  if (value & 0x800)
+    status.temperature = 157;
+  else if (value & 0x400)
+    status.temperature = 150;
+  else if (value & 0x200)
+    status.temperature = 143;
+  else if (value & 0x100)
+    status.temperature = 120;
+  status.current = (value >> 16) & 0x1F;
+
+  uint32_t sg_result;
+  if (!(status.flags & TMC_STANDSTILL) && tmc_read(motor, TMC_REG_SG_RESULT, sg_result))
+    status.load = sg_result >> 1;
+  return true;
+}
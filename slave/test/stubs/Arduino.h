@@ -0,0 +1,15 @@
+#ifndef ARDUINO_STUB_H
+#define ARDUINO_STUB_H
+
+// Just enough of Arduino.h for the native tests of the modules that don't
+// touch the hardware
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#endif
@@ -0,0 +1,83 @@
+#include <unity.h>
+#include "move_profile.h"
+
+// Integration step of the simulated moves (s), in double: 10^5 float steps
+// would drift more than the tolerance
+#define SIM_DT 0.0001
+
+// Runs a trapezoidal move the way the stepper does: speeds up, cruises,
+// brakes in time to stop on the target
+static float simulate_seconds(double steps, double speed, double accel)
+{
+  double position = 0;
+  double velocity = 0;
+  double t = 0;
+  while (position < steps)
+  {
+    if (velocity * velocity / (2 * accel) >= steps - position)
+      velocity = max(velocity - accel * SIM_DT, accel * SIM_DT);
+    else
+      velocity = min(velocity + accel * SIM_DT, speed);
+    position += velocity * SIM_DT;
+    t += SIM_DT;
+  }
+  return (float)t;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_move_seconds(void)
+{
+  // Cruise: 2 s ramps in all, 4000 steps at 400 steps/s
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 11.0f, move_seconds(4000, 400, 400));
+  // Never reaches the speed: 2 * sqrt(100 / 400)
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, move_seconds(100, 400, 400));
+  // Both sides of the limit agree
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, move_seconds(400, 400, 400), move_seconds(399.999f, 400, 400));
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, move_seconds(4000, 400, 400), simulate_seconds(4000, 400, 400));
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, move_seconds(100, 400, 400), simulate_seconds(100, 400, 400));
+}
+
+// The two hands of a dial, COORDINATE_DIAL: the shorter move is slowed down
+// and both end together, on every mix of cruising and short moves
+void test_hands_arrive_together(void)
+{
+  const float distances[] = {20, 300, 1440, 2880, 5760, 11520};
+  const float speeds[] = {200, 400, 800};
+  const float accels[] = {100, 150, 300};
+  for (float speed : speeds)
+    for (float accel : accels)
+      for (float h : distances)
+        for (float m : distances)
+        {
+          float longest = max(move_seconds(h, speed, accel), move_seconds(m, speed, accel));
+          float factor_h = stretch_factor(h, speed, accel, longest);
+          float factor_m = stretch_factor(m, speed, accel, longest);
+          TEST_ASSERT_TRUE(factor_h > 0 && factor_h <= 1);
+          TEST_ASSERT_TRUE(factor_m > 0 && factor_m <= 1);
+          float end_h = simulate_seconds(h, speed * factor_h, accel * factor_h);
+          float end_m = simulate_seconds(m, speed * factor_m, accel * factor_m);
+          // 1 % of the move, or 20 ms for the short ones
+          float tolerance = max(0.02f, longest / 100);
+          TEST_ASSERT_FLOAT_WITHIN(tolerance, longest, end_h);
+          TEST_ASSERT_FLOAT_WITHIN(tolerance, longest, end_m);
+        }
+}
+
+// The slowest move of a group keeps its profile
+void test_longest_unchanged(void)
+{
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, stretch_factor(4000, 400, 150, move_seconds(4000, 400, 150)));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, stretch_factor(50, 400, 150, move_seconds(50, 400, 150)));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_move_seconds);
+  RUN_TEST(test_hands_arrive_together);
+  RUN_TEST(test_longest_unchanged);
+  return UNITY_END();
+}